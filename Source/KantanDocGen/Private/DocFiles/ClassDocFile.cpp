@@ -40,13 +40,13 @@ bool FClassDocFile::InitDocTree(TSharedPtr<DocTreeNode> DocTree, UClass* Class)
 
 	if (!Class->Interfaces.IsEmpty())
 	{
-		auto DocTreeInterfaceList = DocTree->AppendChild("interfaces");
+		auto DocTreeInterfaceList = DocTree->AppendChild(TEXT("interfaces"));
 		for (const auto& Interface : Class->Interfaces)
 		{
 			if (!IsInterfaceDocumentable(Interface))
 				continue;
 
-			auto DocTreeInterface = DocTreeInterfaceList->AppendChild("interface");
+			auto DocTreeInterface = DocTreeInterfaceList->AppendChild(TEXT("interface"));
 			DocTreeInterface->AppendChildWithValueEscaped(TEXT("id"), FDocGenHelper::GetDocId(Interface.Class));
 			DocTreeInterface->AppendChildWithValueEscaped(TEXT("display_name"), FDocGenHelper::GetDisplayName(Interface.Class));
 			DocTreeInterface->AppendChildWithValueEscaped(TEXT("description"), FDocGenHelper::GetDescription(Interface.Class, /*bShortDescription =*/true));
@@ -60,7 +60,7 @@ bool FClassDocFile::InitDocTree(TSharedPtr<DocTreeNode> DocTree, UClass* Class)
 bool FClassDocFile::UpdateParentDoc(TSharedPtr<DocTreeNode> ParentDocTree, UClass* Class) const
 {
 	auto DocTreeClassesElement = FDocGenHelper::GetChildNode(ParentDocTree, TEXT("classes"), /*bCreate = */true);
-	auto DocTreeClass = DocTreeClassesElement->AppendChild("class");
+	auto DocTreeClass = DocTreeClassesElement->AppendChild(TEXT("class"));
 	DocTreeClass->AppendChildWithValueEscaped(TEXT("id"), FDocGenHelper::GetDocId(Class));
 	DocTreeClass->AppendChildWithValueEscaped(TEXT("display_name"), FDocGenHelper::GetDisplayName(Class));
 	DocTreeClass->AppendChildWithValueEscaped(TEXT("description"), FDocGenHelper::GetDescription(Class, /*bShortDescription =*/true));
@@ -72,38 +72,36 @@ bool FClassDocFile::UpdateParentDoc(TSharedPtr<DocTreeNode> ParentDocTree, UClas
 	return true;
 }
 
-bool FClassDocFile::GenerateTypeMembers(UClass* ClassInstance)
+TSharedPtr<DocTreeNode> FClassDocFile::BuildTypeMembers(UClass* ClassInstance)
 {
-	TSharedPtr<DocTreeNode> ClassDocTree = GetDocTree(ClassInstance);
-	bool bIsCreated = false;
-	if (!ClassDocTree.IsValid())
-	{
-		ClassDocTree = CreateDocTree(ClassInstance);
-		bIsCreated = true;
-	}
+	// The existing doc tree may be modified concurrently (e.g. by the node doc workers), the members are built in a
+	// separate tree and only merged into it under the doc tree lock.
+	TSharedPtr<DocTreeNode> ExistingDocTree = GetDocTree(ClassInstance);
+	const bool bIsCreated = !ExistingDocTree.IsValid();
+	TSharedPtr<DocTreeNode> ClassDocTree = bIsCreated ? CreateDocTree(ClassInstance) : MakeShared<DocTreeNode>();
 
 	const bool bIsBlueprintable = FDocGenHelper::IsBlueprintable(ClassInstance);
 	const bool bIsBlueprintType = FDocGenHelper::IsBlueprintType(ClassInstance);
 	const bool bIsHidden = ::IsHidden(ClassInstance);
 	bool bClassShouldBeDocumented = bIsBlueprintable || bIsBlueprintType;
-	bClassShouldBeDocumented |= FDocGenHelper::GenerateFieldsNode(ClassInstance, ClassDocTree);
-	bClassShouldBeDocumented |= FDocGenHelper::GenerateEventsNode(ClassInstance, ClassDocTree);
+	bClassShouldBeDocumented |= FDocGenHelper::GenerateFieldsNode(ClassInstance, ClassDocTree, bDeduplicateInheritedMembers);
+	bClassShouldBeDocumented |= FDocGenHelper::GenerateEventsNode(ClassInstance, ClassDocTree, bDeduplicateInheritedMembers);
 	bClassShouldBeDocumented &= !bIsHidden;
 
 	const bool bHasComment = FDocGenHelper::GenerateDoxygenNode(ClassInstance, ClassDocTree);
 
-	// Only insert this into the map of classdocs if:
-	// - it wasnt already in there,
-	// - we actually need it to be included
-	if (bIsCreated && bClassShouldBeDocumented)
+	if (bHasComment == false)
 	{
-		AddDocTree(ClassInstance, ClassDocTree);
+		FDocGenHelper::PrintWarning(FString::Printf(TEXT("No description for UClass: %s"), *ClassInstance->GetName()));
 	}
 
-	if (bHasComment == false)
+	if (!bIsCreated)
 	{
-		FDocGenHelper::PrintWarning(FString::Printf(TEXT("No description for UClass: %s"), *ClassInstance->GetName()));
+		FScopeLock Lock(&GetDocTreeLock());
+		ExistingDocTree->AppendCopiesOfChildren(*ClassDocTree);
+		return nullptr;
 	}
 
-	return true;
+	// Only insert this into the map of classdocs if we actually need it to be included
+	return bClassShouldBeDocumented ? ClassDocTree : nullptr;
 }
@@ -16,7 +16,7 @@ public:
 
 	virtual bool InitDocTree(TSharedPtr<DocTreeNode> DocTree, UClass* Class) const override;
 	virtual bool UpdateParentDoc(TSharedPtr<DocTreeNode> ParentDocTree, UClass* Class) const override;
-	virtual bool GenerateTypeMembers(UClass* Class) override;
+	virtual TSharedPtr<DocTreeNode> BuildTypeMembers(UClass* Class) override;
 
 protected:
 	virtual FString SubDirName() const { return TEXT("Classes"); }
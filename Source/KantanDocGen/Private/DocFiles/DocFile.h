@@ -8,6 +8,8 @@
 
 #include "CoreMinimal.h"
 #include "DocGenHelper.h"
+#include "KantanDocGenLog.h"
+#include "Misc/ScopeLock.h"
 #include "Templates/SharedPointer.h"
 #include "OutputFormats/DocGenOutputFormatFactoryBase.h"
 
@@ -28,17 +30,47 @@ public:
 
 	TSharedPtr<FDocFile> GetParentFile() const { return ParentFile.Pin(); }
 
-	virtual bool GenerateTypeMembers(UObject* Instance) = 0;
+	// Same as PrepareTypeMembers followed by CommitTypeMembers
+	bool GenerateTypeMembers(UObject* Instance) { return CommitTypeMembers(Instance, PrepareTypeMembers(Instance)); }
+
+	// Builds the members of Instance without adding anything to this file or to the parent doc, so it can be called
+	// concurrently for different instances. Returns the new doc tree of Instance, null if Instance isn't documented or
+	// if its members were added to the doc tree it already had.
+	virtual TSharedPtr<DocTreeNode> PrepareTypeMembers(UObject* Instance) = 0;
+	// Adds the doc tree returned by PrepareTypeMembers to this file and to the parent doc.
+	virtual bool CommitTypeMembers(UObject* Instance, TSharedPtr<DocTreeNode> DocTree) = 0;
+
+	// Directory of the docs of Instance, relative to the output directory. Empty if Instance isn't documented by this file.
+	virtual FString GetDocDirectory(UObject* Instance) const { return FString(); }
+
+	// Only adds Instance to the parent doc (e.g. index), its own docs are kept as generated by a previous run.
+	virtual bool UpdateParentDocOnly(UObject* Instance) { return false; }
+
+	// Streaming finalize: writes the doc of Instance right away and releases its tree, the entry of Instance in the
+	// parent doc is kept. No doc tree can be created for Instance afterwards.
+	virtual TFuture<bool> SaveAndReleaseDocTree(UObject* Instance, FString const& OutDir,
+												const TArray<UDocGenOutputFormatFactoryBase*>& OutputFormats)
+	{
+		return MakeFulfilledPromise<bool>(true).GetFuture();
+	}
 
 	// List of UCLASS/USTRUCT/UENUM meta keys (e.g. "Premium") to look up on documented types and expose
 	// in the generated doc tree, so they can end up in the output frontmatter.
 	void SetCustomMetaKeys(const TArray<FName>& InMetaKeys) { CustomMetaKeys = InMetaKeys; }
 
+	// Members inherited from a super type are only referenced, they are documented once by the type declaring them.
+	void SetDeduplicateInheritedMembers(bool bInDeduplicate) { bDeduplicateInheritedMembers = bInDeduplicate; }
+
+	// Guards the doc trees of this file against child files adding their entries concurrently (e.g. to the index).
+	FCriticalSection& GetChildEntriesLock() const { return ChildEntriesLock; }
+
 protected:
 	TArray<FName> CustomMetaKeys;
+	bool bDeduplicateInheritedMembers = false;
 
 private:
 	TWeakPtr<FDocFile> ParentFile {nullptr};
+	mutable FCriticalSection ChildEntriesLock;
 };
 
 class FRootDocFile : public FDocFile
@@ -62,12 +94,12 @@ public:
 	virtual bool InitDocTree(TSharedPtr<DocTreeNode> DocTree, FString const& DocTitle) const = 0;
 	virtual const FString& GetDocTitle() const override { return DocTitle; }
 	virtual TSharedPtr<DocTreeNode> GetDocTree(UObject* Instance) const override { return DocTree; }
-	virtual bool GenerateTypeMembers(UObject* Instance) override final { return true; }
+	virtual TSharedPtr<DocTreeNode> PrepareTypeMembers(UObject* Instance) override final { return nullptr; }
+	virtual bool CommitTypeMembers(UObject* Instance, TSharedPtr<DocTreeNode> DocTree) override final { return true; }
 	
 	virtual bool SaveFile(FString const& OutDir, const TArray<UDocGenOutputFormatFactoryBase*>& OutputFormats) const
 	{
-		FDocGenHelper::SerializeDocToFile(DocTree, OutDir, GetFileName(), OutputFormats);
-		return true;
+		return FDocGenHelper::SerializeDocToFileAsync(DocTree, OutDir, GetFileName(), OutputFormats).Get();
 	}
 
 protected:
@@ -93,15 +125,40 @@ public:
 		return NewDocTree;
 	}
 
-	virtual bool GenerateTypeMembers(UObject* Instance) override final
+	virtual TSharedPtr<DocTreeNode> PrepareTypeMembers(UObject* Instance) override final
 	{
 		T* CastedInstance = Cast<T>(Instance);
-		return GenerateTypeMembers(CastedInstance);
+		// A new tree would be built for a released instance, CommitTypeMembers reports it
+		return CastedInstance && !IsReleased(CastedInstance) ? BuildTypeMembers(CastedInstance) : nullptr;
+	}
+
+	virtual bool CommitTypeMembers(UObject* Instance, TSharedPtr<DocTreeNode> DocTree) override final
+	{
+		T* CastedInstance = Cast<T>(Instance);
+		if (!CastedInstance)
+		{
+			return true;
+		}
+
+		FScopeLock Lock(&DocTreeLock);
+		if (ReleasedInstances.Contains(CastedInstance))
+		{
+			// Its doc would be listed twice in the parent doc, and the written one overwritten by SaveFile
+			UE_LOG(LogKantanDocGen, Error, TEXT("Docs of %s were already written, its members can't be added anymore."),
+				   *CastedInstance->GetName());
+			return false;
+		}
+		if (DocTree.IsValid())
+		{
+			AddDocTree(CastedInstance, DocTree);
+		}
+		return true;
 	}
 
 	virtual bool InitDocTree(TSharedPtr<DocTreeNode> DocTree, T* Type) const = 0;
 	virtual bool UpdateParentDoc(TSharedPtr<DocTreeNode> DocTree, T* Type) const = 0;
-	virtual bool GenerateTypeMembers(T* Instance) = 0;
+	// @see PrepareTypeMembers
+	virtual TSharedPtr<DocTreeNode> BuildTypeMembers(T* Instance) = 0;
 
 	// If this DocFile is a child of another MultiDocFile, you should provide the parent instance of this instance.
 	// For example, you should return a UClass for a UK2Node instance.
@@ -110,23 +167,65 @@ public:
 
 	virtual bool SaveFile(FString const& OutDir, const TArray<UDocGenOutputFormatFactoryBase*>& OutputFormats) const
 	{
-		FDocGenHelper::SerializeDocMap(DocTreeMap, OutDir / SubDirName(), OutputFormats);
-		return true;
+		FScopeLock Lock(&DocTreeLock);
+		return FDocGenHelper::SerializeDocMap(DocTreeMap, OutDir / SubDirName(), OutputFormats);
 	}
 
 	virtual TSharedPtr<DocTreeNode> GetDocTree(UObject* Instance) const override
 	{
+		FScopeLock Lock(&DocTreeLock);
 		T* CastedInstance = Cast<T>(Instance);
 		return DocTreeMap[CastedInstance];
 	}
 
+	virtual FString GetDocDirectory(UObject* Instance) const override
+	{
+		T* CastedInstance = Cast<T>(Instance);
+		return CastedInstance ? SubDirName() / FDocGenHelper::GetDocId(CastedInstance) : FString();
+	}
+
+	virtual bool UpdateParentDocOnly(UObject* Instance) override
+	{
+		T* CastedInstance = Cast<T>(Instance);
+		if (!CastedInstance)
+			return false;
+
+		FScopeLock Lock(&DocTreeLock);
+		AddToParentDoc(CastedInstance);
+		return true;
+	}
+
+	virtual TFuture<bool> SaveAndReleaseDocTree(UObject* Instance, FString const& OutDir,
+												const TArray<UDocGenOutputFormatFactoryBase*>& OutputFormats) override
+	{
+		T* CastedInstance = Cast<T>(Instance);
+		TSharedPtr<DocTreeNode> DocTree;
+		{
+			FScopeLock Lock(&DocTreeLock);
+			if (CastedInstance)
+			{
+				ReleasedInstances.Add(CastedInstance);
+			}
+			if (!CastedInstance || !DocTreeMap.RemoveAndCopyValue(CastedInstance, DocTree))
+			{
+				return MakeFulfilledPromise<bool>(true).GetFuture();
+			}
+		}
+
+		// The tree is released once written
+		const FString DocId = FDocGenHelper::GetDocId(CastedInstance);
+		return FDocGenHelper::SerializeDocToFileAsync(MoveTemp(DocTree), OutDir / SubDirName() / DocId, DocId, OutputFormats);
+	}
+
+	// Returns null if the doc of Instance has already been released, even if bCreate is set.
 	TSharedPtr<DocTreeNode> GetDocTree(T* Instance, bool bCreate = false)
 	{
+		FScopeLock Lock(&DocTreeLock);
 		TSharedPtr<DocTreeNode>* FoundDocTree = DocTreeMap.Find(Instance);
 		if (FoundDocTree)
 			return *FoundDocTree;
 
-		if (!bCreate)
+		if (!bCreate || ReleasedInstances.Contains(Instance))
 			return nullptr;
 
 		TSharedPtr<DocTreeNode> NewDocTree = CreateDocTree(Instance);
@@ -134,22 +233,41 @@ public:
 		return NewDocTree;
 	}
 
+	// Streaming finalize: whether the doc of Instance has already been written and released
+	bool IsReleased(T* Instance) const
+	{
+		FScopeLock Lock(&DocTreeLock);
+		return ReleasedInstances.Contains(Instance);
+	}
+
 	void Clear()
 	{
+		FScopeLock Lock(&DocTreeLock);
 		DocTreeMap.Empty();
+		ReleasedInstances.Empty();
 	}
 
+	// Guards the doc tree map and the content of the doc trees it holds.
+	// Must be held when modifying one of these doc trees outside of the game thread (e.g. when adding nodes).
+	FCriticalSection& GetDocTreeLock() const { return DocTreeLock; }
+
 protected:
 	virtual FString SubDirName() const = 0;
 
 	void AddDocTree(T* Instance, TSharedPtr<DocTreeNode> DocTree)
 	{
+		FScopeLock Lock(&DocTreeLock);
 		DocTreeMap.Add(Instance, DocTree);
+		AddToParentDoc(Instance);
+	}
 
+	void AddToParentDoc(T* Instance)
+	{
 		TSharedPtr<FDocFile> Parent = GetParentFile();
 		if (!Parent.IsValid())
 			return;
 
+		FScopeLock ParentLock(&Parent->GetChildEntriesLock());
 		UObject* ParentInstance = GetParentInstance();
 		TSharedPtr<DocTreeNode> ParentDoc = Parent->GetDocTree(ParentInstance);
 		if (!ParentDoc.IsValid())
@@ -160,4 +278,8 @@ protected:
 
 private:
 	TMap<TWeakObjectPtr<T>, TSharedPtr<DocTreeNode>> DocTreeMap;
+	// Streaming finalize: instances whose doc has already been written
+	TSet<TWeakObjectPtr<T>> ReleasedInstances;
+	// Recursive, so it can be held while calling back into GetDocTree/AddDocTree.
+	mutable FCriticalSection DocTreeLock;
 };
@@ -23,7 +23,7 @@ bool FEnumDocFile::InitDocTree(TSharedPtr<DocTreeNode> DocTree, UEnum* Enum) con
 bool FEnumDocFile::UpdateParentDoc(TSharedPtr<DocTreeNode> ParentDocTree, UEnum* Enum) const
 {
 	auto DocTreeEnumsElement = FDocGenHelper::GetChildNode(ParentDocTree, TEXT("enums"), /*bCreate = */true);
-	auto DocTreeEnum = DocTreeEnumsElement->AppendChild("enum");
+	auto DocTreeEnum = DocTreeEnumsElement->AppendChild(TEXT("enum"));
 	DocTreeEnum->AppendChildWithValueEscaped(TEXT("id"), FDocGenHelper::GetDocId(Enum));
 	DocTreeEnum->AppendChildWithValueEscaped(TEXT("display_name"), FDocGenHelper::GetDisplayName(Enum));
 	DocTreeEnum->AppendChildWithValueEscaped(TEXT("description"), FDocGenHelper::GetDescription(Enum, /*bShortDescription =*/true));
@@ -32,13 +32,18 @@ bool FEnumDocFile::UpdateParentDoc(TSharedPtr<DocTreeNode> ParentDocTree, UEnum*
 	return true;
 }
 
-bool FEnumDocFile::GenerateTypeMembers(UEnum* EnumInstance)
+TSharedPtr<DocTreeNode> FEnumDocFile::BuildTypeMembers(UEnum* EnumInstance)
 {
-	if ((EnumInstance != nullptr) && EnumInstance->HasAnyFlags(RF_NeedLoad))
 	{
-		EnumInstance->GetLinker()->Preload(EnumInstance);
+		// Enums may be prepared concurrently, at least don't load several of them at once
+		static FCriticalSection LoadLock;
+		FScopeLock Lock(&LoadLock);
+		if ((EnumInstance != nullptr) && EnumInstance->HasAnyFlags(RF_NeedLoad))
+		{
+			EnumInstance->GetLinker()->Preload(EnumInstance);
+		}
+		EnumInstance->ConditionalPostLoad();
 	}
-	EnumInstance->ConditionalPostLoad();
 
 	auto EnumDocTree = CreateDocTree(EnumInstance);
 
@@ -58,17 +63,13 @@ bool FEnumDocFile::GenerateTypeMembers(UEnum* EnumInstance)
 		if (bShouldBeHidden)
 			continue;
 
-		auto Value = ValueList->AppendChild("value");
-		Value->AppendChildWithValueEscaped("name", EnumInstance->GetNameStringByIndex(EnumIndex));
-		Value->AppendChildWithValueEscaped("displayname",
+		auto Value = ValueList->AppendChild(TEXT("value"));
+		Value->AppendChildWithValueEscaped(TEXT("name"), EnumInstance->GetNameStringByIndex(EnumIndex));
+		Value->AppendChildWithValueEscaped(TEXT("displayname"),
 			EnumInstance->GetDisplayNameTextByIndex(EnumIndex).ToString());
-		Value->AppendChildWithValueEscaped("description",
+		Value->AppendChildWithValueEscaped(TEXT("description"),
 			EnumInstance->GetToolTipTextByIndex(EnumIndex).ToString());
 	}
 
-	if (bShouldBeDocumented)
-	{
-		AddDocTree(EnumInstance, EnumDocTree);
-	}
-	return true;
+	return bShouldBeDocumented ? EnumDocTree : nullptr;
 }
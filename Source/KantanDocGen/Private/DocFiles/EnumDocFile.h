@@ -16,7 +16,7 @@ public:
 
 	virtual bool InitDocTree(TSharedPtr<DocTreeNode> DocTree, UEnum* Enum) const override;
 	virtual bool UpdateParentDoc(TSharedPtr<DocTreeNode> ParentDocTree, UEnum* Enum) const override;
-	virtual bool GenerateTypeMembers(UEnum* Enum) override;
+	virtual TSharedPtr<DocTreeNode> BuildTypeMembers(UEnum* Enum) override;
 
 protected:
 	virtual FString SubDirName() const { return TEXT("Enums"); }
@@ -24,7 +24,7 @@ bool FStructDocFile::InitDocTree(TSharedPtr<DocTreeNode> DocTree, UScriptStruct*
 bool FStructDocFile::UpdateParentDoc(TSharedPtr<DocTreeNode> ParentDocTree, UScriptStruct* Struct) const
 {
 	auto DocTreeStructsElement = FDocGenHelper::GetChildNode(ParentDocTree, TEXT("structs"), /*bCreate = */true);
-	auto DocTreeStruct = DocTreeStructsElement->AppendChild("struct");
+	auto DocTreeStruct = DocTreeStructsElement->AppendChild(TEXT("struct"));
 	DocTreeStruct->AppendChildWithValueEscaped(TEXT("id"), FDocGenHelper::GetDocId(Struct));
 	DocTreeStruct->AppendChildWithValueEscaped(TEXT("display_name"), FDocGenHelper::GetDisplayName(Struct));
 	DocTreeStruct->AppendChildWithValueEscaped(TEXT("description"), FDocGenHelper::GetDescription(Struct, /*bShortDescription =*/true));
@@ -33,7 +33,7 @@ bool FStructDocFile::UpdateParentDoc(TSharedPtr<DocTreeNode> ParentDocTree, UScr
 	return true;
 }
 
-bool FStructDocFile::GenerateTypeMembers(UScriptStruct* Struct)
+TSharedPtr<DocTreeNode> FStructDocFile::BuildTypeMembers(UScriptStruct* Struct)
 {
 	if (!Struct->HasAnyFlags(EObjectFlags::RF_ArchetypeObject | EObjectFlags::RF_ClassDefaultObject))
 	{
@@ -46,12 +46,12 @@ bool FStructDocFile::GenerateTypeMembers(UScriptStruct* Struct)
 
 		const bool bIsBlueprintType = FDocGenHelper::IsBlueprintType(Struct);
 		bool bShouldBeDocumented = bIsBlueprintType;
-		bShouldBeDocumented |= FDocGenHelper::GenerateFieldsNode(Struct, StructDocTree);
+		bShouldBeDocumented |= FDocGenHelper::GenerateFieldsNode(Struct, StructDocTree, bDeduplicateInheritedMembers);
 
 		if (bShouldBeDocumented)
 		{
-			AddDocTree(Struct, StructDocTree);
+			return StructDocTree;
 		}
 	}
-	return true;
+	return nullptr;
 }
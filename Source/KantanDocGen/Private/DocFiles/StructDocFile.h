@@ -16,7 +16,7 @@ public:
 
 	virtual bool InitDocTree(TSharedPtr<DocTreeNode> DocTree, UScriptStruct* Struct) const override;
 	virtual bool UpdateParentDoc(TSharedPtr<DocTreeNode> ParentDocTree, UScriptStruct* Struct) const override;
-	virtual bool GenerateTypeMembers(UScriptStruct* Struct) override;
+	virtual TSharedPtr<DocTreeNode> BuildTypeMembers(UScriptStruct* Struct) override;
 
 protected:
 	virtual FString SubDirName() const { return TEXT("Structs"); }
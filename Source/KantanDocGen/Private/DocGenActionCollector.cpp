@@ -0,0 +1,138 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "DocGenActionCollector.h"
+#include "BlueprintActionDatabase.h"
+#include "BlueprintEventNodeSpawner.h"
+#include "BlueprintFunctionNodeSpawner.h"
+#include "BlueprintVariableNodeSpawner.h"
+#include "EdGraphSchema_K2.h"
+#include "Engine/Blueprint.h"
+#include "K2Node.h"
+#include "K2Node_VariableGet.h"
+#include "K2Node_VariableSet.h"
+#include "KantanDocGenLog.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "UObject/UnrealType.h"
+
+FDocGenActionCollector::~FDocGenActionCollector()
+{
+	Empty();
+}
+
+const TArray<UBlueprintNodeSpawner*>& FDocGenActionCollector::GetActions(UObject* Object)
+{
+	if (const TArray<UBlueprintNodeSpawner*>* FoundActions = Actions.Find(Object))
+	{
+		return *FoundActions;
+	}
+
+	TArray<UBlueprintNodeSpawner*>& NewActions = Actions.Add(Object);
+
+	// Same keys as the action database: native classes, and blueprints through the members of their skeleton class
+	if (UBlueprint* Blueprint = Cast<UBlueprint>(Object))
+	{
+		UClass* Class = Blueprint->SkeletonGeneratedClass ? Blueprint->SkeletonGeneratedClass : Blueprint->GeneratedClass;
+		if (Class)
+		{
+			BuildClassActions(Class, NewActions);
+		}
+	}
+	else if (UClass* Class = Cast<UClass>(Object))
+	{
+		if (NeedsActionDatabase(Class))
+		{
+			AddDatabaseActions(Class, NewActions);
+		}
+		else
+		{
+			BuildClassActions(Class, NewActions);
+		}
+	}
+
+	return NewActions;
+}
+
+void FDocGenActionCollector::Empty()
+{
+	for (UBlueprintNodeSpawner* Spawner : BuiltSpawners)
+	{
+		Spawner->RemoveFromRoot();
+	}
+	BuiltSpawners.Empty();
+	Actions.Empty();
+}
+
+bool FDocGenActionCollector::NeedsActionDatabase(UClass* Class)
+{
+	// Node classes register their own actions, async action classes get theirs from UK2Node_AsyncAction
+	return Class->IsChildOf(UK2Node::StaticClass()) || Class->IsChildOf(UBlueprintAsyncActionBase::StaticClass());
+}
+
+void FDocGenActionCollector::AddDatabaseActions(UClass* Class, TArray<UBlueprintNodeSpawner*>& OutActions)
+{
+	// The registrar GetMenuActions expects can only be created by the action database
+	auto& ActionMap = FBlueprintActionDatabase::Get().GetAllActions();
+	if (!bUsedActionDatabase)
+	{
+		UE_LOG(LogKantanDocGen, Display,
+			   TEXT("Actions of '%s' are registered by K2 nodes, building the whole action database for them."),
+			   *Class->GetName());
+		bUsedActionDatabase = true;
+		for (auto const& Pair : ActionMap)
+		{
+			NumBuilt += Pair.Value.Num();
+		}
+	}
+
+	if (auto DatabaseActions = ActionMap.Find(Class))
+	{
+		for (UBlueprintNodeSpawner* Spawner : *DatabaseActions)
+		{
+			OutActions.Add(Spawner);
+		}
+	}
+}
+
+void FDocGenActionCollector::BuildClassActions(UClass* Class, TArray<UBlueprintNodeSpawner*>& OutActions)
+{
+	for (TFieldIterator<UFunction> FunctionIt(Class, EFieldIteratorFlags::ExcludeSuper); FunctionIt; ++FunctionIt)
+	{
+		UFunction* Function = *FunctionIt;
+		if (UEdGraphSchema_K2::CanUserKismetCallFunction(Function))
+		{
+			AddAction(UBlueprintFunctionNodeSpawner::Create(Function), OutActions);
+		}
+		if (UEdGraphSchema_K2::FunctionCanBePlacedAsEvent(Function))
+		{
+			AddAction(UBlueprintEventNodeSpawner::Create(Function), OutActions);
+		}
+	}
+
+	// Delegate spawners are never documented, only getters and setters are built
+	for (TFieldIterator<FProperty> PropertyIt(Class, EFieldIteratorFlags::ExcludeSuper); PropertyIt; ++PropertyIt)
+	{
+		FProperty* Property = *PropertyIt;
+		if (UEdGraphSchema_K2::CanUserKismetAccessVariable(Property, Class, UEdGraphSchema_K2::CannotBeDelegate))
+		{
+			AddAction(UBlueprintVariableNodeSpawner::CreateFromMemberOrParam(UK2Node_VariableGet::StaticClass(), Property),
+					  OutActions);
+			AddAction(UBlueprintVariableNodeSpawner::CreateFromMemberOrParam(UK2Node_VariableSet::StaticClass(), Property),
+					  OutActions);
+		}
+	}
+}
+
+void FDocGenActionCollector::AddAction(UBlueprintNodeSpawner* Spawner, TArray<UBlueprintNodeSpawner*>& OutActions)
+{
+	if (Spawner)
+	{
+		Spawner->AddToRoot();
+		BuiltSpawners.Add(Spawner);
+		OutActions.Add(Spawner);
+		++NumBuilt;
+	}
+}
@@ -0,0 +1,44 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBlueprintNodeSpawner;
+
+// Builds the blueprint actions of the documented types only, as opposed to FBlueprintActionDatabase which builds the
+// actions of every class and asset on first access. The member functions, events and variables of a type are built
+// directly. Node classes and async action classes get their actions from K2 node registration (GetMenuActions), which
+// only the action database can run, so these fall back to the database and pay for its full build.
+// Built spawners are rooted until Empty() is called. Game thread only.
+class FDocGenActionCollector
+{
+public:
+	~FDocGenActionCollector();
+
+	// Actions of a native class or of a blueprint, built on the first call for that object.
+	const TArray<UBlueprintNodeSpawner*>& GetActions(UObject* Object);
+	void Empty();
+
+	// Includes the whole action database once a type had to fall back to it
+	int32 GetNumBuilt() const { return NumBuilt; }
+	bool HasUsedActionDatabase() const { return bUsedActionDatabase; }
+
+	// Types whose actions are registered by K2 nodes rather than by their members
+	static bool NeedsActionDatabase(UClass* Class);
+
+private:
+	void BuildClassActions(UClass* Class, TArray<UBlueprintNodeSpawner*>& OutActions);
+	void AddDatabaseActions(UClass* Class, TArray<UBlueprintNodeSpawner*>& OutActions);
+	void AddAction(UBlueprintNodeSpawner* Spawner, TArray<UBlueprintNodeSpawner*>& OutActions);
+
+	TMap<TWeakObjectPtr<UObject>, TArray<UBlueprintNodeSpawner*>> Actions;
+	// Spawners built by this collector, the ones of the action database are owned by it
+	TArray<UBlueprintNodeSpawner*> BuiltSpawners;
+	int32 NumBuilt = 0;
+	bool bUsedActionDatabase = false;
+};
@@ -26,6 +26,10 @@ UDocGenCommandlet::UDocGenCommandlet()
 	HelpParamNames.Add("includeclass");
 	HelpParamDescriptions.Add("Comma-separated list of classes to document");
 
+	HelpParamNames.Add("includedependencies");
+	HelpParamDescriptions.Add("Also documents the structs and enums used by the members of the classes given with "
+							  "-includeclass");
+
 	HelpParamNames.Add("excludeclass");
 	HelpParamDescriptions.Add("Comma-separated list of classes to exclude");
 
@@ -41,6 +45,42 @@ UDocGenCommandlet::UDocGenCommandlet()
 	HelpParamNames.Add("cleanoutput");
 	HelpParamDescriptions.Add("cleans the output directory before generating the documentation");
 
+	HelpParamNames.Add("dedupinherited");
+	HelpParamDescriptions.Add("Documents inherited properties and events only on the type declaring them, subclasses "
+							  "reference them");
+
+	HelpParamNames.Add("nodebatchsize");
+	HelpParamDescriptions.Add("Number of nodes spawned and rendered per game thread visit");
+
+	HelpParamNames.Add("targetedactions");
+	HelpParamDescriptions.Add("Builds the blueprint actions of the documented types only, instead of the actions of "
+							  "every class and asset");
+
+	HelpParamNames.Add("prefetchwindow");
+	HelpParamDescriptions.Add("Number of content blueprints loaded asynchronously ahead of the one being documented, 0 "
+							  "loads them one at a time");
+
+	HelpParamNames.Add("imagecache");
+	HelpParamDescriptions.Add("Reuses the node images cached by previous runs instead of rendering every node, delete "
+							  "Intermediate/KantanDocGen/ImageCache after changing how nodes are drawn");
+
+	HelpParamNames.Add("incremental");
+	HelpParamDescriptions.Add("Only regenerates the documentation of the types that changed since the previous run");
+
+	HelpParamNames.Add("atlas");
+	HelpParamDescriptions.Add("Renders node images in batches, into shared atlases");
+
+	HelpParamNames.Add("streamingfinalize");
+	HelpParamDescriptions.Add("Writes the docs of each type as soon as it is complete, keeping memory usage bounded by the "
+							  "largest type instead of the whole project");
+
+	HelpParamNames.Add("benchmark");
+	HelpParamDescriptions.Add("Cold run (no image cache, no incremental build) saving a JSON report of the timings of each "
+							  "stage. Documents the Engine and UMG modules as xml unless sources and formats are given");
+
+	HelpParamNames.Add("benchmarkreport");
+	HelpParamDescriptions.Add("Path of the benchmark report, implies -benchmark");
+
 	HelpParamNames.Add("template");
 	HelpParamDescriptions.Add("Path to the template file to use when rendering output for formats that require it");
 }
@@ -94,6 +134,11 @@ int32 UDocGenCommandlet::Main(const FString& Params)
 		}
 	}
 
+	if (Switches.Contains("includedependencies"))
+	{
+		Settings.bIncludeSpecificClassDependencies = true;
+	}
+
 	if (ParsedParams.Contains("excludeclass"))
 	{
 		TArray<FString> Values;
@@ -109,12 +154,30 @@ int32 UDocGenCommandlet::Main(const FString& Params)
 		Settings.OutputDirectory.Path = ParsedParams["outputdir"];
 	}
 
+	const bool bBenchmark = Switches.Contains("benchmark") || ParsedParams.Contains("benchmarkreport");
+	if (bBenchmark && !Settings.HasAnySources())
+	{
+		// Fixed set of modules, so reports of different plugin versions can be compared
+		Settings.NativeModules.Add(TEXT("Engine"));
+		Settings.NativeModules.Add(TEXT("UMG"));
+	}
+
+	FString Formats;
 	if (ParsedParams.Contains("formats"))
+	{
+		Formats = ParsedParams["formats"];
+	}
+	else if (bBenchmark)
+	{
+		Formats = TEXT("xml");
+	}
+
+	if (!Formats.IsEmpty())
 	{
 		auto OutputFormatFactories = GetAllOutputFormatFactories();
 
 		TArray<FString> Values;
-		ParsedParams["formats"].ParseIntoArray(Values, TEXT(","));
+		Formats.ParseIntoArray(Values, TEXT(","));
 		for (const auto& Value : Values)
 		{
 			for (const auto& Factory : OutputFormatFactories)
@@ -136,6 +199,54 @@ int32 UDocGenCommandlet::Main(const FString& Params)
 	{
 		Settings.bCleanOutputDirectory = true;
 	}
+	if (Switches.Contains("dedupinherited"))
+	{
+		Settings.bDeduplicateInheritedMembers = true;
+	}
+	if (Switches.Contains("atlas"))
+	{
+		Settings.bUseAtlasRendering = true;
+	}
+	if (Switches.Contains("streamingfinalize"))
+	{
+		Settings.bStreamingFinalize = true;
+	}
+	if (Switches.Contains("incremental"))
+	{
+		Settings.bIncrementalBuild = true;
+	}
+	if (Switches.Contains("targetedactions"))
+	{
+		Settings.bTargetedActionRegistration = true;
+	}
+	if (Switches.Contains("imagecache"))
+	{
+		Settings.bUseImageCache = true;
+	}
+	if (ParsedParams.Contains("nodebatchsize"))
+	{
+		Settings.NodeBatchSize = FMath::Max(1, FCString::Atoi(*ParsedParams["nodebatchsize"]));
+	}
+	if (ParsedParams.Contains("prefetchwindow"))
+	{
+		Settings.ContentPrefetchWindow = FMath::Max(0, FCString::Atoi(*ParsedParams["prefetchwindow"]));
+	}
+	if (bBenchmark)
+	{
+		// Measure the whole pipeline, nothing reused from previous runs
+		Settings.bUseImageCache = false;
+		Settings.bIncrementalBuild = false;
+
+		if (ParsedParams.Contains("benchmarkreport"))
+		{
+			Settings.BenchmarkReportPath = ParsedParams["benchmarkreport"];
+		}
+		else
+		{
+			Settings.BenchmarkReportPath = FPaths::ProjectSavedDir() / TEXT("KantanDocGen") / TEXT("Benchmarks") /
+										   FDateTime::Now().ToString() + TEXT(".json");
+		}
+	}
 	auto& Module = FModuleManager::LoadModuleChecked<FKantanDocGenModule>(TEXT("KantanDocGen"));
 	auto GenerateDocsResult = Module.GenerateDocs(Settings);
 	while (!GenerateDocsResult.IsReady())
@@ -0,0 +1,72 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "DocGenFieldCache.h"
+#include "EdGraphSchema_K2.h"
+#include "Misc/ScopeRWLock.h"
+
+FDocGenFieldCache& FDocGenFieldCache::Get()
+{
+	static FDocGenFieldCache Cache;
+	return Cache;
+}
+
+FString FDocGenFieldCache::FindOrAdd(EValue Value, const void* Field, TFunctionRef<FString()> Compute)
+{
+	const FFieldKey Key {Field, Value};
+	const uint32 Hash = GetTypeHash(Key);
+	FShard& Shard = Shards[Hash >> (32 - NumShardBits)];
+	{
+		FReadScopeLock Lock(Shard.Lock);
+		if (const FString* Found = Shard.Values.FindByHash(Hash, Key))
+		{
+			NumHits.fetch_add(1, std::memory_order_relaxed);
+			return *Found;
+		}
+	}
+
+	NumMisses.fetch_add(1, std::memory_order_relaxed);
+	FString Computed = Compute();
+	FWriteScopeLock Lock(Shard.Lock);
+	Shard.Values.AddByHash(Hash, Key, Computed);
+	return Computed;
+}
+
+FString FDocGenFieldCache::GetPinTypeText(const FEdGraphPinType& PinType)
+{
+	const FPinTypeKey Key {PinType};
+	{
+		FReadScopeLock Lock(PinTypesLock);
+		if (const FString* Found = PinTypes.Find(Key))
+		{
+			NumHits.fetch_add(1, std::memory_order_relaxed);
+			return *Found;
+		}
+	}
+
+	NumMisses.fetch_add(1, std::memory_order_relaxed);
+	FString Computed = UEdGraphSchema_K2::TypeToText(PinType).ToString();
+	FWriteScopeLock Lock(PinTypesLock);
+	PinTypes.Add(Key, Computed);
+	return Computed;
+}
+
+void FDocGenFieldCache::Reset()
+{
+	for (FShard& Shard : Shards)
+	{
+		FWriteScopeLock Lock(Shard.Lock);
+		Shard.Values.Empty();
+	}
+
+	{
+		FWriteScopeLock Lock(PinTypesLock);
+		PinTypes.Empty();
+	}
+
+	NumHits.store(0, std::memory_order_relaxed);
+	NumMisses.store(0, std::memory_order_relaxed);
+}
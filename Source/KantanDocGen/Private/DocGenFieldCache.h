@@ -0,0 +1,88 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EdGraph/EdGraphPin.h"
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
+
+// Strings computed from reflection data, memoized for the duration of a run. The same property is documented as a
+// field of its owner and of each of its subclasses, as a function parameter and as a variable node.
+// Keyed by pointer, so it must be reset between runs (fields may be destroyed and their memory reused).
+class FDocGenFieldCache
+{
+public:
+	enum class EValue : uint8
+	{
+		TypeSignature,
+		DisplayName,
+		Description,
+		ShortDescription,
+		TypeHierarchy,
+	};
+
+	static FDocGenFieldCache& Get();
+
+	/** Callable from any thread */
+	// Returns the memoized value for Field, computed by Compute the first time. Compute may run more than once when
+	// threads miss the same value concurrently.
+	FString FindOrAdd(EValue Value, const void* Field, TFunctionRef<FString()> Compute);
+	// UEdGraphSchema_K2::TypeToText, pin types are compared by value
+	FString GetPinTypeText(const FEdGraphPinType& PinType);
+	/**/
+
+	void Reset();
+	int32 GetNumHits() const { return NumHits.load(std::memory_order_relaxed); }
+	int32 GetNumMisses() const { return NumMisses.load(std::memory_order_relaxed); }
+
+private:
+	struct FFieldKey
+	{
+		const void* Field;
+		EValue Value;
+
+		bool operator==(const FFieldKey& Other) const { return Field == Other.Field && Value == Other.Value; }
+		friend uint32 GetTypeHash(const FFieldKey& Key)
+		{
+			return HashCombine(::GetTypeHash(Key.Field), ::GetTypeHash(static_cast<uint8>(Key.Value)));
+		}
+	};
+
+	// Values are spread over several maps (by the high bits of their hash) so threads generating different types
+	// don't wait on each other
+	static constexpr int32 NumShardBits = 4;
+	static constexpr int32 NumShards = 1 << NumShardBits;
+	struct FShard
+	{
+		FRWLock Lock;
+		TMap<FFieldKey, FString> Values;
+	};
+	FShard Shards[NumShards];
+
+	struct FPinTypeKey
+	{
+		FEdGraphPinType PinType;
+
+		bool operator==(const FPinTypeKey& Other) const { return PinType == Other.PinType; }
+		friend uint32 GetTypeHash(const FPinTypeKey& Key)
+		{
+			uint32 Hash = HashCombine(::GetTypeHash(Key.PinType.PinCategory), ::GetTypeHash(Key.PinType.PinSubCategory));
+			Hash = HashCombine(Hash, ::GetTypeHash(Key.PinType.PinSubCategoryObject.Get()));
+			Hash = HashCombine(Hash, ::GetTypeHash(Key.PinType.PinValueType.TerminalCategory));
+			Hash = HashCombine(Hash, ::GetTypeHash(Key.PinType.PinValueType.TerminalSubCategoryObject.Get()));
+			return HashCombine(Hash, ::GetTypeHash(static_cast<uint8>(Key.PinType.ContainerType)));
+		}
+	};
+
+	FRWLock PinTypesLock;
+	TMap<FPinTypeKey, FString> PinTypes;
+
+	std::atomic<int32> NumHits {0};
+	std::atomic<int32> NumMisses {0};
+};
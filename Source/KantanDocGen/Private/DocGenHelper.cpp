@@ -5,14 +5,19 @@
 // Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
 
 #include "DocGenHelper.h"
+#include "DocGenFieldCache.h"
 #include "K2Node_DynamicCast.h"
 #include "K2Node_Message.h"
 #include "DocTreeNode.h"
 #include "OutputFormats/DocGenOutputFormatFactoryBase.h"
 #include "DoxygenParserHelpers.h"
 #include "KantanDocGenLog.h"
+#include "KantanDocGenTrace.h"
+#include "ThreadingHelpers.h"
 #include "K2Node_Variable.h"
 #include "K2Node_CallFunction.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
 
 void FDocGenHelper::TrimTarget(FString& Str)
 {
@@ -48,15 +53,28 @@ FString FDocGenHelper::GetObjectRawDisplayName(const UObject* Obj)
 bool FDocGenHelper::GenerateDoxygenNodeFromComment(const FString& Comment, TSharedPtr<DocTreeNode> ParentNode)
 {
 	check(ParentNode.IsValid());
-	auto DoxygenTags = Detail::ParseDoxygenTagsForString(Comment);
-	if (DoxygenTags.Num())
+	// Values are grouped by tag (case insensitive), tags in the order of their first occurrence. Tags are views into
+	// Comment, values are copied as they may not outlive the visitor call.
+	TArray<FStringView, TInlineAllocator<8>> Tags;
+	TArray<TArray<FString>, TInlineAllocator<8>> Values;
+	Detail::ForEachDoxygenTag(Comment, [&Tags, &Values](FStringView Tag, FStringView Value) {
+		int32 TagIndex = Tags.IndexOfByPredicate([Tag](FStringView Other) { return Other.Equals(Tag, ESearchCase::IgnoreCase); });
+		if (TagIndex == INDEX_NONE)
+		{
+			TagIndex = Tags.Add(Tag);
+			Values.AddDefaulted();
+		}
+		Values[TagIndex].Emplace(Value);
+	});
+
+	if (Tags.Num())
 	{
-		auto DoxygenElement = ParentNode->AppendChild("doxygen");
-		for (auto CurrentTag : DoxygenTags)
+		TSharedPtr<DocTreeNode> DoxygenElement = ParentNode->AppendChild(TEXT("doxygen"));
+		for (int32 TagIndex = 0; TagIndex < Tags.Num(); ++TagIndex)
 		{
-			for (auto CurrentValue : CurrentTag.Value)
+			for (const FString& Value : Values[TagIndex])
 			{
-				DoxygenElement->AppendChildWithValueEscaped(CurrentTag.Key, CurrentValue);
+				DoxygenElement->AppendChildWithValueEscaped(Tags[TagIndex], Value);
 			}
 		}
 	}
@@ -106,7 +124,7 @@ bool FDocGenHelper::ExtractPinInformation(const UEdGraphPin* Pin, FString& OutNa
 		OutName = Pin->Direction == EEdGraphPinDirection::EGPD_Input ? TEXT("In") : TEXT("Out");
 	}
 
-	OutType = UEdGraphSchema_K2::TypeToText(Pin->PinType).ToString();
+	OutType = FDocGenFieldCache::Get().GetPinTypeText(Pin->PinType);
 
 	return true;
 }
@@ -175,11 +193,13 @@ FString FDocGenHelper::GetNodeDescription(const UEdGraphNode* Node)
 FString FDocGenHelper::GetTypeSignature(const FProperty* Property)
 {
 	check(Property);
-	FString ExtendedParameters;
-	FString ParamConst = (Property->PropertyFlags & CPF_ConstParm) ? TEXT("const ") : TEXT("");
-	FString ParamRef = (Property->PropertyFlags & CPF_ReferenceParm) ? TEXT("&") : TEXT("");
-	FString ParamType = Property->GetCPPType(&ExtendedParameters);
-	return ParamConst + ParamType + ExtendedParameters + ParamRef;
+	return FDocGenFieldCache::Get().FindOrAdd(FDocGenFieldCache::EValue::TypeSignature, Property, [Property]() {
+		FString ExtendedParameters;
+		FString ParamConst = (Property->PropertyFlags & CPF_ConstParm) ? TEXT("const ") : TEXT("");
+		FString ParamRef = (Property->PropertyFlags & CPF_ReferenceParm) ? TEXT("&") : TEXT("");
+		FString ParamType = Property->GetCPPType(&ExtendedParameters);
+		return ParamConst + ParamType + ExtendedParameters + ParamRef;
+	});
 }
 
 FString FDocGenHelper::GetEventSignature(const FProperty* Property)
@@ -194,13 +214,23 @@ FString FDocGenHelper::GetEventSignature(const FProperty* Property)
 // UField are UClass, UStruct and UEnum (is there a way to merge with FField?)
 FString FDocGenHelper::GetDisplayName(const UField* Field)
 {
-	return Field ? Field->GetDisplayNameText().ToString() : FString("None");
+	if (!Field)
+		return FString("None");
+
+	return FDocGenFieldCache::Get().FindOrAdd(FDocGenFieldCache::EValue::DisplayName, Field, [Field]() {
+		return Field->GetDisplayNameText().ToString();
+	});
 }
 
 // FField are FProperty (is there a way to merge with UField?)
 FString FDocGenHelper::GetDisplayName(const FField* Field)
 {
-	return Field ? Field->GetDisplayNameText().ToString() : FString("None");
+	if (!Field)
+		return FString("None");
+
+	return FDocGenFieldCache::Get().FindOrAdd(FDocGenFieldCache::EValue::DisplayName, Field, [Field]() {
+		return Field->GetDisplayNameText().ToString();
+	});
 }
 
 FString FDocGenHelper::GetDescription(const UField* Field, bool bShortDescription)
@@ -213,28 +243,36 @@ FString FDocGenHelper::GetDescription(const UField* Field, bool bShortDescriptio
 			bShortDescription = true;
 	}
 
-	const FString Description = Field->GetToolTipText(bShortDescription).ToString();
+	const FDocGenFieldCache::EValue Value =
+		bShortDescription ? FDocGenFieldCache::EValue::ShortDescription : FDocGenFieldCache::EValue::Description;
+	return FDocGenFieldCache::Get().FindOrAdd(Value, Field, [Field, bShortDescription]() {
+		const FString Description = Field->GetToolTipText(bShortDescription).ToString();
 
-	#if UE_VERSION_OLDER_THAN(5, 8, 0)
-	const FString DefaultDescription = GetObjectRawDisplayName(Field);
-	#else
-	const FString DefaultDescription = GetDisplayName(Field);
-	#endif
+		#if UE_VERSION_OLDER_THAN(5, 8, 0)
+		const FString DefaultDescription = GetObjectRawDisplayName(Field);
+		#else
+		const FString DefaultDescription = GetDisplayName(Field);
+		#endif
 
-	if (Description == DefaultDescription)
-		return FString();
+		if (Description == DefaultDescription)
+			return FString();
 
-	return Description;
+		return Description;
+	});
 }
 
 FString FDocGenHelper::GetDescription(const FField* Field, bool bShortDescription)
 {
 	check(Field);
-	FString Description = Field->GetToolTipText(bShortDescription).ToString();
-	if (Description == GetRawDisplayName(Field->GetName()))
-		return FString();
+	const FDocGenFieldCache::EValue Value =
+		bShortDescription ? FDocGenFieldCache::EValue::ShortDescription : FDocGenFieldCache::EValue::Description;
+	return FDocGenFieldCache::Get().FindOrAdd(Value, Field, [Field, bShortDescription]() {
+		FString Description = Field->GetToolTipText(bShortDescription).ToString();
+		if (Description == GetRawDisplayName(Field->GetName()))
+			return FString();
 
-	return Description;
+		return Description;
+	});
 }
 
 FString FDocGenHelper::GetSourcePath(const UField* Field)
@@ -253,16 +291,16 @@ FString FDocGenHelper::GetSourcePath(const UField* Field)
 FString FDocGenHelper::GetTypeHierarchy(const UStruct* Struct)
 {
 	check(Struct);
-	const UStruct* Parent = Struct->GetSuperStruct();
-	FString OutputStr = FDocGenHelper::GetDisplayName(Struct);
-	while (nullptr != Parent)
-	{
-		// TODO: Create a node list of classes, with a possible ClassDocId if they belong to the doc too.
-		// So we could create links in the generated doc to the related parent class pages.
-		OutputStr = FString::Printf(TEXT("%s > %s"), *FDocGenHelper::GetDisplayName(Parent), *OutputStr);
-		Parent = Parent->GetSuperStruct();
-	}
-	return OutputStr;
+	// TODO: Create a node list of classes, with a possible ClassDocId if they belong to the doc too.
+	// So we could create links in the generated doc to the related parent class pages.
+	// Built from the memoized hierarchy of the parent, each class of a deep hierarchy only appends its own name.
+	return FDocGenFieldCache::Get().FindOrAdd(FDocGenFieldCache::EValue::TypeHierarchy, Struct, [Struct]() {
+		const UStruct* Parent = Struct->GetSuperStruct();
+		if (nullptr == Parent)
+			return FDocGenHelper::GetDisplayName(Struct);
+
+		return FDocGenHelper::GetTypeHierarchy(Parent) + TEXT(" > ") + FDocGenHelper::GetDisplayName(Struct);
+	});
 }
 
 FString FDocGenHelper::GetClassGroup(const UClass* Class)
@@ -425,7 +463,7 @@ bool FDocGenHelper::GenerateDoxygenNode(const FField* Field, TSharedPtr<DocTreeN
 	return GenerateDoxygenNodeFromComment(Comment, ParentNode);
 }
 
-bool FDocGenHelper::GenerateFieldsNode(const UStruct* Struct, TSharedPtr<DocTreeNode> ParentNode)
+bool FDocGenHelper::GenerateFieldsNode(const UStruct* Struct, TSharedPtr<DocTreeNode> ParentNode, bool bCompactInherited)
 {
 	check(Struct && ParentNode.IsValid());
 	bool bHasProperties = false;
@@ -443,10 +481,15 @@ bool FDocGenHelper::GenerateFieldsNode(const UStruct* Struct, TSharedPtr<DocTree
 
 		auto MemberList = FDocGenHelper::GetChildNode(ParentNode, TEXT("fields"), /*bCreate = */true);
 		auto Member = MemberList->AppendChild(TEXT("field"));
-		Member->AppendChildWithValueEscaped("name", PropertyIterator->GetNameCPP());
-		Member->AppendChildWithValueEscaped("display_name", FDocGenHelper::GetDisplayName(*PropertyIterator));
-		Member->AppendChildWithValueEscaped("type", FDocGenHelper::GetTypeSignature(*PropertyIterator));
-		Member->AppendChildWithValueEscaped("category", FDocGenHelper::GetCategory(*PropertyIterator));
+		Member->AppendChildWithValueEscaped(TEXT("name"), PropertyIterator->GetNameCPP());
+		if (bCompactInherited && PropertyIterator->Owner.Get<UField>() != Struct)
+		{
+			GenerateInheritanceNode(*PropertyIterator, Struct, Member);
+			continue;
+		}
+		Member->AppendChildWithValueEscaped(TEXT("display_name"), FDocGenHelper::GetDisplayName(*PropertyIterator));
+		Member->AppendChildWithValueEscaped(TEXT("type"), FDocGenHelper::GetTypeSignature(*PropertyIterator));
+		Member->AppendChildWithValueEscaped(TEXT("category"), FDocGenHelper::GetCategory(*PropertyIterator));
 
 		const bool bInherited = FDocGenHelper::GenerateInheritanceNode(*PropertyIterator, Struct, Member);
 		bHasProperties |= !bInherited;
@@ -459,22 +502,22 @@ bool FDocGenHelper::GenerateFieldsNode(const UStruct* Struct, TSharedPtr<DocTree
 
 		if (!BlueprintAccess.IsEmpty())
 		{
-			Member->AppendChildWithValueEscaped("blueprint_access", BlueprintAccess);
+			Member->AppendChildWithValueEscaped(TEXT("blueprint_access"), BlueprintAccess);
 		}
 
 		if (!EditorAccess.IsEmpty())
 		{
-			Member->AppendChildWithValueEscaped("editor_access", EditorAccess);
+			Member->AppendChildWithValueEscaped(TEXT("editor_access"), EditorAccess);
 		}
 
 		if (bDeprecated)
 		{
 			FText DetailedMessage =
 				FText::FromString(PropertyIterator->GetMetaData(FBlueprintMetadata::MD_DeprecationMessage));
-			Member->AppendChildWithValueEscaped("deprecated", DetailedMessage.ToString());
+			Member->AppendChildWithValueEscaped(TEXT("deprecated"), DetailedMessage.ToString());
 		}
 
-		Member->AppendChildWithValueEscaped("description", FDocGenHelper::GetDescription(*PropertyIterator));
+		Member->AppendChildWithValueEscaped(TEXT("description"), FDocGenHelper::GetDescription(*PropertyIterator));
 
 		// Generate the detailed doxygen tags from the comment.
 		const bool bHasComment = GenerateDoxygenNode(*PropertyIterator, Member);
@@ -497,7 +540,7 @@ bool FDocGenHelper::GenerateFieldsNode(const UStruct* Struct, TSharedPtr<DocTree
 	return bHasProperties;
 }
 
-bool FDocGenHelper::GenerateEventsNode(const UStruct* Struct, TSharedPtr<DocTreeNode> ParentNode)
+bool FDocGenHelper::GenerateEventsNode(const UStruct* Struct, TSharedPtr<DocTreeNode> ParentNode, bool bCompactInherited)
 {
 	check(Struct && ParentNode.IsValid());
 	bool bHasEvent = false;
@@ -511,10 +554,15 @@ bool FDocGenHelper::GenerateEventsNode(const UStruct* Struct, TSharedPtr<DocTree
 
 		auto EventList = FDocGenHelper::GetChildNode(ParentNode, TEXT("events"), /*bCreate = */true);
 		auto Event = EventList->AppendChild(TEXT("event"));
-		Event->AppendChildWithValueEscaped("name", PropertyIterator->GetNameCPP());
-		Event->AppendChildWithValueEscaped("display_name", FDocGenHelper::GetDisplayName(*PropertyIterator));
-		Event->AppendChildWithValueEscaped("signature", FDocGenHelper::GetEventSignature(*PropertyIterator));
-		Event->AppendChildWithValueEscaped("category", FDocGenHelper::GetCategory(*PropertyIterator));
+		Event->AppendChildWithValueEscaped(TEXT("name"), PropertyIterator->GetNameCPP());
+		if (bCompactInherited && PropertyIterator->Owner.Get<UField>() != Struct)
+		{
+			GenerateInheritanceNode(*PropertyIterator, Struct, Event);
+			continue;
+		}
+		Event->AppendChildWithValueEscaped(TEXT("display_name"), FDocGenHelper::GetDisplayName(*PropertyIterator));
+		Event->AppendChildWithValueEscaped(TEXT("signature"), FDocGenHelper::GetEventSignature(*PropertyIterator));
+		Event->AppendChildWithValueEscaped(TEXT("category"), FDocGenHelper::GetCategory(*PropertyIterator));
 
 		const bool bInherited = FDocGenHelper::GenerateInheritanceNode(*PropertyIterator, Struct, Event);
 		bHasEvent |= !bInherited;
@@ -528,10 +576,10 @@ bool FDocGenHelper::GenerateEventsNode(const UStruct* Struct, TSharedPtr<DocTree
 		{
 			FText DetailedMessage =
 				FText::FromString(PropertyIterator->GetMetaData(FBlueprintMetadata::MD_DeprecationMessage));
-			Event->AppendChildWithValueEscaped("deprecated", DetailedMessage.ToString());
+			Event->AppendChildWithValueEscaped(TEXT("deprecated"), DetailedMessage.ToString());
 		}
 
-		Event->AppendChildWithValueEscaped("description", FDocGenHelper::GetDescription(*PropertyIterator));
+		Event->AppendChildWithValueEscaped(TEXT("description"), FDocGenHelper::GetDescription(*PropertyIterator));
 
 		// Generate the detailed doxygen tags from the comment.
 		const bool bHasComment = GenerateDoxygenNode(*PropertyIterator, Event);
@@ -579,8 +627,8 @@ bool FDocGenHelper::GenerateInheritanceNode(const FField* Field, const UField* P
 	if (bInherited)
 	{
 		auto InheritanceNode = ParentNode->AppendChild(TEXT("inheritedFrom"));
-		InheritanceNode->AppendChildWithValueEscaped("id", FDocGenHelper::GetDocId(Owner));
-		InheritanceNode->AppendChildWithValueEscaped("display_name", FDocGenHelper::GetDisplayName(Owner));
+		InheritanceNode->AppendChildWithValueEscaped(TEXT("id"), FDocGenHelper::GetDocId(Owner));
+		InheritanceNode->AppendChildWithValueEscaped(TEXT("display_name"), FDocGenHelper::GetDisplayName(Owner));
 	}
 	return bInherited;
 }
@@ -628,18 +676,156 @@ FString FDocGenHelper::GetDocId(const UEdGraphNode* Node)
 	return Node->GetDocumentationExcerptName();
 }
 
+std::atomic<uint64> FDocGenHelper::SerializeDocToFileCycles {0};
+
+namespace
+{
+	bool SerializeDocWith(const DocTreeNode& Doc, TSharedPtr<DocTreeNode::IDocTreeSerializer> Serializer,
+						  const FString& OutputDirectory, const FString& FileName)
+	{
+		KANTANDOCGEN_TRACE_SCOPE(FDocGenHelper::SerializeDocToFile);
+		DocGenThreads::FScopedCycleAccumulator CycleCounter(FDocGenHelper::SerializeDocToFileCycles);
+		FDocGenHelper::RecordWrittenFile(OutputDirectory / FileName);
+		Serializer->BeginFile(OutputDirectory, FileName);
+		Doc.SerializeWith(Serializer);
+		return Serializer->SaveToFile(OutputDirectory, FileName);
+	}
+
+	// Shared by the tasks writing the formats of one doc, the last one to complete sets the result
+	struct FDocWriteState
+	{
+		TPromise<bool> Promise;
+		std::atomic<int32> NumPending {0};
+		std::atomic<bool> bSuccess {true};
+	};
+}
+
 bool FDocGenHelper::SerializeDocToFile(TSharedPtr<DocTreeNode> Doc, const FString& OutputDirectory, const FString& FileName, const TArray<UDocGenOutputFormatFactoryBase*>& OutputFormats)
 {
 	bool bSuccess = true;
 	for (const auto& FactoryObject : OutputFormats)
 	{
-		auto Serializer = FactoryObject->CreateSerializer();
-		Doc->SerializeWith(Serializer);
-		bSuccess &= Serializer->SaveToFile(OutputDirectory, FileName);
+		bSuccess &= SerializeDocWith(*Doc, FactoryObject->CreateSerializer(), OutputDirectory, FileName);
 	}
 	return bSuccess;
 }
 
+TFuture<bool> FDocGenHelper::SerializeDocToFileAsync(TSharedPtr<DocTreeNode> Doc, const FString& OutputDirectory, const FString& FileName, const TArray<UDocGenOutputFormatFactoryBase*>& OutputFormats)
+{
+	if (OutputFormats.Num() == 0)
+	{
+		return MakeFulfilledPromise<bool>(true).GetFuture();
+	}
+
+	// Each format walks the tree with its own serializer. This may run on several threads at once, which is fine as
+	// CreateSerializer is thread safe, @see UDocGenOutputFormatFactoryBase.
+	TSharedRef<FDocWriteState> State = MakeShared<FDocWriteState>();
+	State->NumPending = OutputFormats.Num();
+	TFuture<bool> Result = State->Promise.GetFuture();
+	for (const auto& FactoryObject : OutputFormats)
+	{
+		// Thread pool rather than task graph, so task graph workers can wait on the result without starving it
+		Async(EAsyncExecution::ThreadPool,
+			  [State, Doc, Serializer = FactoryObject->CreateSerializer(), OutputDirectory, FileName]() {
+				  if (!SerializeDocWith(*Doc, Serializer, OutputDirectory, FileName))
+				  {
+					  State->bSuccess = false;
+				  }
+				  if (--State->NumPending == 0)
+				  {
+					  State->Promise.SetValue(State->bSuccess);
+				  }
+			  });
+	}
+	return Result;
+}
+
+bool FDocGenHelper::WaitForDocWrites(TArray<TFuture<bool>>& Writes)
+{
+	KANTANDOCGEN_TRACE_SCOPE(FDocGenHelper::WaitForDocWrites);
+	bool bSuccess = true;
+	for (TFuture<bool>& Write : Writes)
+	{
+		bSuccess &= Write.Get();
+	}
+	Writes.Reset();
+	return bSuccess;
+}
+
+namespace
+{
+	// Paths without extensions (e.g. "Classes/Actor/Actor" for "Actor.xml" and "Actor.rows.json")
+	TSet<FString> WrittenFiles;
+	bool bRecordingWrittenFiles = false;
+	FCriticalSection WrittenFilesLock;
+
+	FString GetPathWithoutExtensions(const FString& Path)
+	{
+		FString Normalized = Path;
+		FPaths::NormalizeFilename(Normalized);
+		FString Directory;
+		FString FileName;
+		if (!Normalized.Split(TEXT("/"), &Directory, &FileName, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+		{
+			FileName = MoveTemp(Normalized);
+		}
+
+		int32 DotIndex = INDEX_NONE;
+		if (FileName.FindChar(TEXT('.'), DotIndex))
+		{
+			FileName.LeftInline(DotIndex);
+		}
+		return Directory / FileName;
+	}
+}
+
+void FDocGenHelper::BeginRecordingWrittenFiles()
+{
+	FScopeLock Lock(&WrittenFilesLock);
+	WrittenFiles.Reset();
+	bRecordingWrittenFiles = true;
+}
+
+void FDocGenHelper::EndRecordingWrittenFiles()
+{
+	FScopeLock Lock(&WrittenFilesLock);
+	WrittenFiles.Empty();
+	bRecordingWrittenFiles = false;
+}
+
+void FDocGenHelper::RecordWrittenFile(const FString& Path)
+{
+	FScopeLock Lock(&WrittenFilesLock);
+	if (bRecordingWrittenFiles)
+	{
+		WrittenFiles.Add(GetPathWithoutExtensions(Path));
+	}
+}
+
+int32 FDocGenHelper::DeleteFilesNotWritten(const FString& Directory)
+{
+	TArray<FString> Files;
+	IFileManager::Get().FindFilesRecursive(Files, *Directory, TEXT("*"), true, false);
+
+	int32 NumDeleted = 0;
+	{
+		FScopeLock Lock(&WrittenFilesLock);
+		for (const FString& File : Files)
+		{
+			if (!WrittenFiles.Contains(GetPathWithoutExtensions(File)) && IFileManager::Get().Delete(*File, false, true, true))
+			{
+				++NumDeleted;
+			}
+		}
+	}
+
+	if (NumDeleted == Files.Num())
+	{
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	}
+	return NumDeleted;
+}
+
 // Return true if the directoy has been created.
 bool FDocGenHelper::CreateImgDir(const FString& ParentDirectory)
 {
@@ -7,6 +7,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
+
+#include <atomic>
 
 #define ENABLE_TEAMCITY_LOGS 1
 
@@ -16,7 +19,6 @@ private:
 	static void TrimTarget(FString& Str);
 	static FString GetRawDisplayName(const FString& Name);
 	static FString GetObjectRawDisplayName(const UObject* Obj);
-	static bool GenerateDoxygenNodeFromComment(const FString& Comment, TSharedPtr<DocTreeNode> ParentNode);
 	static bool ShouldDocumentPin(const UEdGraphPin* Pin);
 	static bool ExtractPinInformation(const UEdGraphPin* Pin, FString& OutName, FString& OutType, FString& OutDescription);
 	static bool GetBoolMetadata(const UField* Field, const FName& MetadataName);
@@ -67,8 +69,12 @@ public:
 
 	// FField are FProperty (is there a way to merge with UField?)
 	static bool GenerateDoxygenNode(const FField* Field, TSharedPtr<DocTreeNode> ParentNode);
-	static bool GenerateFieldsNode(const UStruct* Struct, TSharedPtr<DocTreeNode> ParentNode);
-	static bool GenerateEventsNode(const UStruct* Struct, TSharedPtr<DocTreeNode> ParentNode);
+	// Comment is the raw "Comment" metadata of a field
+	static bool GenerateDoxygenNodeFromComment(const FString& Comment, TSharedPtr<DocTreeNode> ParentNode);
+	// With bCompactInherited, members inherited from a super type are only referenced by name (see inheritedFrom),
+	// their full entry is the one of the doc of the type declaring them.
+	static bool GenerateFieldsNode(const UStruct* Struct, TSharedPtr<DocTreeNode> ParentNode, bool bCompactInherited = false);
+	static bool GenerateEventsNode(const UStruct* Struct, TSharedPtr<DocTreeNode> ParentNode, bool bCompactInherited = false);
 	static bool GenerateParamNode(const UEdGraphPin* Pin, TSharedPtr<DocTreeNode> ParentNode);
 	static bool GenerateInheritanceNode(const FField* Field, const UField* Parent, TSharedPtr<DocTreeNode> ParentNode);
 
@@ -90,18 +96,38 @@ public:
 	}
 
 	static bool SerializeDocToFile(TSharedPtr<DocTreeNode> Doc, const FString& OutputDirectory, const FString& FileName, const TArray<UDocGenOutputFormatFactoryBase*>& OutputFormats);
+	// Writes each output format of Doc in its own thread pool task, the future is set once all of them are on disk.
+	// Doc must not be modified until then.
+	static TFuture<bool> SerializeDocToFileAsync(TSharedPtr<DocTreeNode> Doc, const FString& OutputDirectory, const FString& FileName, const TArray<UDocGenOutputFormatFactoryBase*>& OutputFormats);
+	// Blocks until all the writes have completed, returns false if any of them failed.
+	static bool WaitForDocWrites(TArray<TFuture<bool>>& Writes);
+	// Cycles spent serializing docs, accumulated across all threads
+	static std::atomic<uint64> SerializeDocToFileCycles;
+
+	// Incremental builds: keeps track of the docs and images written from now on (from any thread), so the files a
+	// regenerated type doesn't have anymore can be told apart, @see DeleteFilesNotWritten.
+	static void BeginRecordingWrittenFiles();
+	static void EndRecordingWrittenFiles();
+	// Only the path without its extensions is recorded, all the formats of a doc count as written.
+	static void RecordWrittenFile(const FString& Path);
+	// Deletes the files of Directory (recursively) that haven't been written since BeginRecordingWrittenFiles, and
+	// Directory itself if nothing is left in it. Returns the number of deleted files.
+	static int32 DeleteFilesNotWritten(const FString& Directory);
 
 	// Return true if the directoy has been created.
 	static bool CreateImgDir(const FString& ParentDirectory);
 
 	template<class T>
-	static void SerializeDocMap(TMap<T, TSharedPtr<DocTreeNode>> Map, const FString& OutputDirectory, const TArray<UDocGenOutputFormatFactoryBase*>& OutputFormats)
+	static bool SerializeDocMap(const TMap<T, TSharedPtr<DocTreeNode>>& Map, const FString& OutputDirectory, const TArray<UDocGenOutputFormatFactoryBase*>& OutputFormats)
 	{
+		TArray<TFuture<bool>> Writes;
+		Writes.Reserve(Map.Num());
 		for (const auto& Entry : Map)
 		{
 			auto DocId = GetDocId(Entry.Key);
 			const auto DocPath = OutputDirectory / DocId;
-			FDocGenHelper::SerializeDocToFile(Entry.Value, DocPath, DocId, OutputFormats);
+			Writes.Add(FDocGenHelper::SerializeDocToFileAsync(Entry.Value, DocPath, DocId, OutputFormats));
 		}
+		return WaitForDocWrites(Writes);
 	}
 };
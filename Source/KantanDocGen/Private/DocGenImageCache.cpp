@@ -0,0 +1,130 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "DocGenImageCache.h"
+#include "EdGraph/EdGraphNode.h"
+#include "EdGraph/EdGraphPin.h"
+#include "HAL/FileManager.h"
+#include "KantanDocGenLog.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#if UE_VERSION_OLDER_THAN(5, 1, 0)
+	#include "EditorStyleSet.h"
+#else
+	#include "Styling/AppStyle.h"
+#endif
+
+namespace
+{
+	// Bump this to invalidate all the cached images (e.g. when the way nodes are rendered changes).
+	const TCHAR* const ImageCacheVersion = TEXT("1");
+
+	void HashString(FSHA1& Sha, const FString& String)
+	{
+		// Separate the values, so that ("ab", "c") and ("a", "bc") don't produce the same hash
+		Sha.UpdateWithString(*String, String.Len());
+		Sha.UpdateWithString(TEXT("|"), 1);
+	}
+
+	void HashPinType(FSHA1& Sha, const FEdGraphPinType& PinType)
+	{
+		HashString(Sha, PinType.PinCategory.ToString());
+		HashString(Sha, PinType.PinSubCategory.ToString());
+		HashString(Sha, PinType.PinSubCategoryObject.IsValid() ? PinType.PinSubCategoryObject->GetPathName() : FString());
+		HashString(Sha, PinType.PinValueType.TerminalCategory.ToString());
+		HashString(Sha, PinType.PinValueType.TerminalSubCategory.ToString());
+		HashString(Sha, FString::Printf(TEXT("%d%d%d"), (int32) PinType.ContainerType, PinType.bIsReference, PinType.bIsConst));
+	}
+} // namespace
+
+FDocGenImageCache::FDocGenImageCache(const FString& InCacheDir)
+	: CacheDir(InCacheDir)
+{}
+
+FString FDocGenImageCache::GetDefaultCacheDir()
+{
+	return FPaths::ProjectIntermediateDir() / TEXT("KantanDocGen") / TEXT("ImageCache");
+}
+
+FString FDocGenImageCache::ComputeNodeKey(const UEdGraphNode* Node)
+{
+	check(Node);
+
+	FSHA1 Sha;
+	HashString(Sha, ImageCacheVersion);
+	HashString(Sha, FEngineVersion::Current().ToString());
+#if UE_VERSION_OLDER_THAN(5, 1, 0)
+	HashString(Sha, FEditorStyle::GetStyleSetName().ToString());
+#else
+	HashString(Sha, FAppStyle::GetAppStyleSetName().ToString());
+#endif
+
+	HashString(Sha, Node->GetClass()->GetPathName());
+	HashString(Sha, Node->GetNodeTitle(ENodeTitleType::FullTitle).ToString());
+	HashString(Sha, Node->GetNodeTitleColor().ToString());
+	HashString(Sha, FString::Printf(TEXT("%d"), (int32) Node->AdvancedPinDisplay.GetValue()));
+
+	for (const UEdGraphPin* Pin : Node->Pins)
+	{
+		HashString(Sha, Pin->PinName.ToString());
+		HashString(Sha, Pin->GetDisplayName().ToString());
+		HashPinType(Sha, Pin->PinType);
+		HashString(Sha, Pin->DefaultValue);
+		HashString(Sha, Pin->DefaultObject ? Pin->DefaultObject->GetPathName() : FString());
+		HashString(Sha, Pin->DefaultTextValue.ToString());
+		HashString(Sha, FString::Printf(TEXT("%d%d%d%d"), (int32) Pin->Direction, Pin->bHidden, Pin->bAdvancedView,
+										Pin->bDefaultValueIsIgnored));
+	}
+
+	Sha.Final();
+	FSHAHash Hash;
+	Sha.GetHash(Hash.Hash);
+	return Hash.ToString();
+}
+
+bool FDocGenImageCache::Contains(const FString& Key) const
+{
+	return IFileManager::Get().FileExists(*GetCachedImagePath(Key));
+}
+
+bool FDocGenImageCache::CopyCachedImage(const FString& Key, const FString& DestPath)
+{
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(DestPath), true);
+	if (IFileManager::Get().Copy(*DestPath, *GetCachedImagePath(Key)) != COPY_OK)
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to copy cached image %s to %s"), *Key, *DestPath);
+		return false;
+	}
+
+	NumHits.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+bool FDocGenImageCache::StoreImage(const FString& Key, const FString& SourcePath)
+{
+	// Copy to a unique file first and move it in place, so another thread never sees a partially written image
+	const FString CachedImagePath = GetCachedImagePath(Key);
+	const FString TempPath = CachedImagePath + TEXT(".") + FGuid::NewGuid().ToString() + TEXT(".tmp");
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(CachedImagePath), true);
+	if (IFileManager::Get().Copy(*TempPath, *SourcePath) != COPY_OK ||
+		!IFileManager::Get().Move(*CachedImagePath, *TempPath, /*bReplace = */ true))
+	{
+		IFileManager::Get().Delete(*TempPath, false, true, true);
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to store %s in the image cache"), *SourcePath);
+		return false;
+	}
+
+	NumStored.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+FString FDocGenImageCache::GetCachedImagePath(const FString& Key) const
+{
+	// Shard on the first two characters to keep directories small
+	return CacheDir / Key.Left(2) / Key + TEXT(".png");
+}
@@ -0,0 +1,50 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+class UEdGraphNode;
+
+// Persistent cache of node images, keyed on a hash of everything that affects how a node widget is drawn.
+// Lives outside of the documentation intermediate directory, so it survives between runs.
+class FDocGenImageCache
+{
+public:
+	explicit FDocGenImageCache(const FString& InCacheDir);
+
+	static FString GetDefaultCacheDir();
+
+	/** Callable only from game thread */
+	// Reads node titles and pins, which may not be safe to do while the node is being modified.
+	static FString ComputeNodeKey(const UEdGraphNode* Node);
+	/**/
+
+	/** Callable from any thread */
+	bool Contains(const FString& Key) const;
+	// Copies the cached image to DestPath, returns false if the image is not in the cache or the copy failed.
+	bool CopyCachedImage(const FString& Key, const FString& DestPath);
+	// Adds a freshly written image to the cache.
+	bool StoreImage(const FString& Key, const FString& SourcePath);
+	/**/
+
+	void RecordMiss() { NumMisses.fetch_add(1, std::memory_order_relaxed); }
+	int32 GetNumHits() const { return NumHits.load(std::memory_order_relaxed); }
+	int32 GetNumMisses() const { return NumMisses.load(std::memory_order_relaxed); }
+	int32 GetNumStored() const { return NumStored.load(std::memory_order_relaxed); }
+
+protected:
+	FString GetCachedImagePath(const FString& Key) const;
+
+private:
+	FString CacheDir;
+	std::atomic<int32> NumHits {0};
+	std::atomic<int32> NumMisses {0};
+	std::atomic<int32> NumStored {0};
+};
@@ -0,0 +1,373 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "DocGenManifest.h"
+#include "DocGenSettings.h"
+#include "Engine/Blueprint.h"
+#include "Json.h"
+#include "KantanDocGenLog.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Misc/FileHelper.h"
+#include "Misc/SecureHash.h"
+#include "OutputFormats/DocGenOutputFormatFactoryBase.h"
+#include "UObject/MetaData.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	// Bump this when the layout of the manifest file changes.
+	const int32 ManifestVersion = 2;
+
+	// Bump this whenever the generator changes what it writes for a type (intermediate docs, output formats, images),
+	// so that docs generated by an older plugin are never kept by an incremental build.
+	const int32 DocFormatVersion = 5;
+
+	void HashString(FSHA1& Sha, const FString& String)
+	{
+		// Separate the values, so that ("ab", "c") and ("a", "bc") don't produce the same hash
+		Sha.UpdateWithString(*String, String.Len());
+		Sha.UpdateWithString(TEXT("|"), 1);
+	}
+
+	void HashMetaData(FSHA1& Sha, const TMap<FName, FString>* MetaData)
+	{
+		if (MetaData == nullptr)
+		{
+			return;
+		}
+
+		// Don't depend on the insertion order
+		TArray<FName> Keys;
+		MetaData->GetKeys(Keys);
+		Keys.Sort(FNameLexicalLess());
+		for (const FName& Key : Keys)
+		{
+			HashString(Sha, Key.ToString());
+			HashString(Sha, MetaData->FindChecked(Key));
+		}
+	}
+
+	const TMap<FName, FString>* GetObjectMetaData(const UObject* Object)
+	{
+#if UE_VERSION_OLDER_THAN(5, 6, 0)
+		return UMetaData::GetMapForObject(Object);
+#else
+		return FMetaData::GetMapForObject(Object);
+#endif
+	}
+
+	void HashProperty(FSHA1& Sha, const FProperty* Property)
+	{
+		HashString(Sha, Property->GetName());
+		HashString(Sha, Property->GetCPPType());
+		HashString(Sha, FString::Printf(TEXT("%llu %d"), (uint64) Property->PropertyFlags, Property->ArrayDim));
+		HashMetaData(Sha, Property->GetMetaDataMap());
+	}
+
+	void HashEnumValues(FSHA1& Sha, const UEnum* Enum)
+	{
+		HashString(Sha, Enum->CppType);
+		for (int32 Index = 0; Index < Enum->NumEnums(); ++Index)
+		{
+			HashString(Sha, Enum->GetNameStringByIndex(Index));
+			HashString(Sha, LexToString(Enum->GetValueByIndex(Index)));
+		}
+	}
+
+	FString ToHashString(FSHA1& Sha)
+	{
+		Sha.Final();
+		FSHAHash Hash;
+		Sha.GetHash(Hash.Hash);
+		return Hash.ToString();
+	}
+} // namespace
+
+bool FDocGenManifest::Load(const FString& Path)
+{
+	FString Content;
+	if (!FFileHelper::LoadFileToString(Content, *Path))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Root;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Content), Root) || !Root.IsValid())
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to parse doc manifest %s"), *Path);
+		return false;
+	}
+
+	int32 Version = 0;
+	if (!Root->TryGetNumberField(TEXT("version"), Version) || Version != ManifestVersion)
+	{
+		return false;
+	}
+
+	SettingsFingerprint = Root->GetStringField(TEXT("settings"));
+
+	TypeFingerprints.Empty();
+	const TSharedPtr<FJsonObject>* Types = nullptr;
+	if (Root->TryGetObjectField(TEXT("types"), Types))
+	{
+		for (const auto& Pair : (*Types)->Values)
+		{
+			TypeFingerprints.Add(Pair.Key, Pair.Value->AsString());
+		}
+	}
+
+	Contributions.Empty();
+	Contributors.Empty();
+	const TSharedPtr<FJsonObject>* ContributionsObject = nullptr;
+	if (Root->TryGetObjectField(TEXT("contributions"), ContributionsObject))
+	{
+		for (const auto& Pair : (*ContributionsObject)->Values)
+		{
+			TSet<FString>& Targets = Contributions.Add(Pair.Key);
+			for (const TSharedPtr<FJsonValue>& Target : Pair.Value->AsArray())
+			{
+				Targets.Add(Target->AsString());
+				Contributors.FindOrAdd(Target->AsString()).Add(Pair.Key);
+			}
+		}
+	}
+
+	return true;
+}
+
+bool FDocGenManifest::Save(const FString& Path) const
+{
+	TSharedRef<FJsonObject> Types = MakeShared<FJsonObject>();
+	for (const auto& Pair : TypeFingerprints)
+	{
+		Types->SetStringField(Pair.Key, Pair.Value);
+	}
+
+	TSharedRef<FJsonObject> ContributionsObject = MakeShared<FJsonObject>();
+	for (const auto& Pair : Contributions)
+	{
+		TArray<TSharedPtr<FJsonValue>> Targets;
+		for (const FString& Target : FindContributionTargets(Pair.Key))
+		{
+			Targets.Add(MakeShared<FJsonValueString>(Target));
+		}
+		ContributionsObject->SetArrayField(Pair.Key, Targets);
+	}
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetNumberField(TEXT("version"), ManifestVersion);
+	Root->SetStringField(TEXT("settings"), SettingsFingerprint);
+	Root->SetObjectField(TEXT("types"), Types);
+	Root->SetObjectField(TEXT("contributions"), ContributionsObject);
+
+	FString Content;
+	if (!FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Content)) ||
+		!FFileHelper::SaveStringToFile(Content, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to save doc manifest %s"), *Path);
+		return false;
+	}
+
+	return true;
+}
+
+void FDocGenManifest::CopyContributions(const FDocGenManifest& From, const FString& SourceDocDir)
+{
+	if (const TSet<FString>* Targets = From.Contributions.Find(SourceDocDir))
+	{
+		Contributions.FindOrAdd(SourceDocDir).Append(*Targets);
+	}
+}
+
+TArray<FString> FDocGenManifest::FindContributionTargets(const FString& SourceDocDir) const
+{
+	TArray<FString> Targets;
+	if (const TSet<FString>* Found = Contributions.Find(SourceDocDir))
+	{
+		Targets = Found->Array();
+		Targets.Sort();
+	}
+	return Targets;
+}
+
+UObject* FDocGenManifest::GetDocumentedType(UObject* Object)
+{
+	if (auto Blueprint = Cast<UBlueprint>(Object))
+	{
+		return Blueprint->GeneratedClass;
+	}
+	return Object;
+}
+
+FString FDocGenManifest::ComputeSettingsFingerprint(const FKantanDocGenSettings& Settings)
+{
+	FSHA1 Sha;
+	HashString(Sha, FString::FromInt(ManifestVersion));
+	HashString(Sha, FString::FromInt(DocFormatVersion));
+	HashString(Sha, FEngineVersion::Current().ToString());
+	HashString(Sha, Settings.DocumentationTitle);
+	HashString(Sha, Settings.BlueprintContextClass ? Settings.BlueprintContextClass->GetPathName() : FString());
+	HashString(Sha, Settings.bDeduplicateInheritedMembers ? TEXT("DeduplicateInheritedMembers") : TEXT(""));
+	HashString(Sha, Settings.bTargetedActionRegistration ? TEXT("TargetedActionRegistration") : TEXT(""));
+	// Node images are kept by incremental builds, they must have been rendered the same way
+	HashString(Sha, Settings.bUseAtlasRendering ? TEXT("AtlasRendering") : TEXT(""));
+	HashString(Sha, Settings.bUseImageCache ? TEXT("ImageCache") : TEXT(""));
+
+	for (const FName& Key : Settings.CustomMetaKeys)
+	{
+		HashString(Sha, Key.ToString());
+	}
+
+	for (const FName& Name : Settings.ExcludedClasses)
+	{
+		HashString(Sha, Name.ToString());
+	}
+
+	for (UDocGenOutputFormatFactoryBase* Factory : Settings.OutputFormats)
+	{
+		if (Factory == nullptr)
+		{
+			continue;
+		}
+
+		HashString(Sha, Factory->GetFormatIdentifier());
+		FDocGenOutputFormatFactorySettings FactorySettings = Factory->SaveSettings();
+		FactorySettings.SettingValues.KeySort(TLess<FString>());
+		for (const auto& Pair : FactorySettings.SettingValues)
+		{
+			HashString(Sha, Pair.Key);
+			HashString(Sha, Pair.Value);
+		}
+	}
+
+	return ToHashString(Sha);
+}
+
+FString FDocGenManifest::ComputeTypeFingerprint(const UObject* Type)
+{
+	if (Type == nullptr)
+	{
+		return FString();
+	}
+
+	if (const FString* Cached = FingerprintCache.Find(Type))
+	{
+		return *Cached;
+	}
+
+	FSHA1 Sha;
+	HashString(Sha, Type->GetClass()->GetName());
+	HashString(Sha, Type->GetPathName());
+	// Includes ModuleRelativePath, tooltips and comments
+	HashMetaData(Sha, GetObjectMetaData(Type));
+
+	if (const UStruct* Struct = Cast<UStruct>(Type))
+	{
+		HashString(Sha, ComputeTypeFingerprint(Struct->GetSuperStruct()));
+
+		for (TFieldIterator<FProperty> PropertyIt(Struct, EFieldIteratorFlags::ExcludeSuper); PropertyIt; ++PropertyIt)
+		{
+			HashProperty(Sha, *PropertyIt);
+			HashReferencedTypes(Sha, *PropertyIt);
+		}
+
+		for (TFieldIterator<UFunction> FunctionIt(Struct, EFieldIteratorFlags::ExcludeSuper); FunctionIt; ++FunctionIt)
+		{
+			const UFunction* Function = *FunctionIt;
+			HashString(Sha, Function->GetName());
+			HashString(Sha, FString::Printf(TEXT("%u"), (uint32) Function->FunctionFlags));
+			HashMetaData(Sha, GetObjectMetaData(Function));
+			for (TFieldIterator<FProperty> ParamIt(Function); ParamIt; ++ParamIt)
+			{
+				HashProperty(Sha, *ParamIt);
+				HashReferencedTypes(Sha, *ParamIt);
+			}
+		}
+
+		if (const UClass* Class = Cast<UClass>(Struct))
+		{
+			// Runtime flags (e.g. CLASS_Constructed) would make the hash unstable, only keep the documented ones
+			const EClassFlags DocumentedFlags = CLASS_Abstract | CLASS_Hidden | CLASS_Deprecated | CLASS_Interface |
+												CLASS_Const | CLASS_Native;
+			HashString(Sha, FString::Printf(TEXT("%u"), (uint32) (Class->ClassFlags & DocumentedFlags)));
+			for (const FImplementedInterface& Interface : Class->Interfaces)
+			{
+				HashString(Sha, Interface.Class ? Interface.Class->GetPathName() : FString());
+			}
+		}
+	}
+	else if (const UEnum* Enum = Cast<UEnum>(Type))
+	{
+		HashEnumValues(Sha, Enum);
+	}
+
+	FString Fingerprint = ToHashString(Sha);
+	FingerprintCache.Add(Type, Fingerprint);
+	return Fingerprint;
+}
+
+void FDocGenManifest::HashReferencedTypes(FSHA1& Sha, const FProperty* Property)
+{
+	if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+	{
+		HashString(Sha, ComputeReferencedTypeFingerprint(StructProperty->Struct));
+	}
+	else if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+	{
+		HashString(Sha, ComputeReferencedTypeFingerprint(EnumProperty->GetEnum()));
+	}
+	else if (const FByteProperty* ByteProperty = CastField<FByteProperty>(Property))
+	{
+		HashString(Sha, ComputeReferencedTypeFingerprint(ByteProperty->Enum));
+	}
+	else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+	{
+		HashReferencedTypes(Sha, ArrayProperty->Inner);
+	}
+	else if (const FSetProperty* SetProperty = CastField<FSetProperty>(Property))
+	{
+		HashReferencedTypes(Sha, SetProperty->ElementProp);
+	}
+	else if (const FMapProperty* MapProperty = CastField<FMapProperty>(Property))
+	{
+		HashReferencedTypes(Sha, MapProperty->KeyProp);
+		HashReferencedTypes(Sha, MapProperty->ValueProp);
+	}
+}
+
+FString FDocGenManifest::ComputeReferencedTypeFingerprint(const UField* Type)
+{
+	if (Type == nullptr)
+	{
+		return FString();
+	}
+
+	if (const FString* Cached = ReferencedTypeCache.Find(Type))
+	{
+		return *Cached;
+	}
+
+	// Not recursive, a struct may (indirectly) contain itself
+	FSHA1 Sha;
+	HashString(Sha, Type->GetPathName());
+	HashMetaData(Sha, GetObjectMetaData(Type));
+	if (const UStruct* Struct = Cast<UStruct>(Type))
+	{
+		for (TFieldIterator<FProperty> PropertyIt(Struct); PropertyIt; ++PropertyIt)
+		{
+			HashProperty(Sha, *PropertyIt);
+		}
+	}
+	else if (const UEnum* Enum = Cast<UEnum>(Type))
+	{
+		HashEnumValues(Sha, Enum);
+	}
+
+	FString Fingerprint = ToHashString(Sha);
+	ReferencedTypeCache.Add(Type, Fingerprint);
+	return Fingerprint;
+}
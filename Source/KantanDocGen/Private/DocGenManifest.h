@@ -0,0 +1,68 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FProperty;
+class FSHA1;
+class UField;
+struct FKantanDocGenSettings;
+
+// Fingerprints of the documented types, persisted between runs to allow incremental builds.
+// A type whose fingerprint didn't change since the previous run doesn't need to be documented again.
+class FDocGenManifest
+{
+public:
+	bool Load(const FString& Path);
+	bool Save(const FString& Path) const;
+
+	// The object owning the reflection data documented for an enumerated object (e.g. the generated class of a blueprint).
+	static UObject* GetDocumentedType(UObject* Object);
+
+	// Hash of everything in the settings that affects the content of the intermediate docs.
+	static FString ComputeSettingsFingerprint(const FKantanDocGenSettings& Settings);
+
+	/** Callable only from game thread */
+	// Hash of the metadata, properties, functions and hierarchy of a class/struct/enum.
+	// Super types are part of the hash, as their members are documented in their children too. So are the structs and
+	// enums used by its properties and function parameters, their own fields and values but not the types these use.
+	FString ComputeTypeFingerprint(const UObject* Type);
+	/**/
+
+	void SetSettingsFingerprint(const FString& InFingerprint) { SettingsFingerprint = InFingerprint; }
+	const FString& GetSettingsFingerprint() const { return SettingsFingerprint; }
+
+	// Types are keyed on their doc directory, relative to the intermediate directory (e.g. "Classes/Actor").
+	void SetTypeFingerprint(const FString& TypeDocDir, const FString& Fingerprint) { TypeFingerprints.Add(TypeDocDir, Fingerprint); }
+	const FString* FindTypeFingerprint(const FString& TypeDocDir) const { return TypeFingerprints.Find(TypeDocDir); }
+	const TMap<FString, FString>& GetTypeFingerprints() const { return TypeFingerprints; }
+
+	// Classes a source added nodes to, besides its own type (e.g. a blueprint function library adds nodes to the classes
+	// of its target parameters). Sources are keyed on the doc directory of their type too.
+	void AddContribution(const FString& SourceDocDir, const FString& TargetDocDir) { Contributions.FindOrAdd(SourceDocDir).Add(TargetDocDir); }
+	// Keeps the contributions of a source that wasn't enumerated again from the manifest of the previous run
+	void CopyContributions(const FDocGenManifest& From, const FString& SourceDocDir);
+	TArray<FString> FindContributionTargets(const FString& SourceDocDir) const;
+	// Sources that added nodes to the class documented in TargetDocDir
+	TArray<FString> FindContributors(const FString& TargetDocDir) const { return Contributors.FindRef(TargetDocDir); }
+
+private:
+	void HashReferencedTypes(FSHA1& Sha, const FProperty* Property);
+	FString ComputeReferencedTypeFingerprint(const UField* Type);
+
+private:
+	FString SettingsFingerprint;
+	TMap<FString, FString> TypeFingerprints;
+	TMap<FString, TSet<FString>> Contributions;
+	// Reverse of Contributions, only built by Load
+	TMap<FString, TArray<FString>> Contributors;
+	// Super types are hashed many times, once per child
+	TMap<const UObject*, FString> FingerprintCache;
+	// Common structs (e.g. FVector) are used by most types
+	TMap<const UField*, FString> ReferencedTypeCache;
+};
@@ -0,0 +1,75 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "DocGenRenderTargetPool.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Misc/EngineVersionComparison.h"
+
+namespace
+{
+	// Smallest bucket, most nodes fit in a couple of buckets above it
+	const int32 MinBucketSize = 256;
+}
+
+FDocGenRenderTargetPool::~FDocGenRenderTargetPool()
+{
+	Empty();
+}
+
+FIntPoint FDocGenRenderTargetPool::GetBucketSize(FIntPoint MinSize)
+{
+	return FIntPoint(FMath::RoundUpToPowerOfTwo(FMath::Max(MinSize.X, MinBucketSize)),
+					 FMath::RoundUpToPowerOfTwo(FMath::Max(MinSize.Y, MinBucketSize)));
+}
+
+UTextureRenderTarget2D* FDocGenRenderTargetPool::Acquire(FIntPoint MinSize, EPixelFormat Format)
+{
+	const FBucketKey Key {GetBucketSize(MinSize), Format};
+
+	if (TArray<UTextureRenderTarget2D*>* Bucket = FreeTargets.Find(Key))
+	{
+		if (Bucket->Num() > 0)
+		{
+			++NumReused;
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+			return Bucket->Pop(false);
+#else
+			return Bucket->Pop(EAllowShrinking::No);
+#endif
+		}
+	}
+
+	// Set SRGB=true independently of the gamma correction of the widget renderer
+	UTextureRenderTarget2D* RenderTarget = NewObject<UTextureRenderTarget2D>();
+	RenderTarget->Filter = TF_Default;
+	RenderTarget->ClearColor = FLinearColor::Transparent;
+	RenderTarget->SRGB = true;
+	RenderTarget->TargetGamma = 1;
+	RenderTarget->InitCustomFormat(Key.Size.X, Key.Size.Y, Format, /*bForceLinearGamma=*/true);
+	RenderTarget->UpdateResourceImmediate(true);
+	RenderTarget->AddToRoot();
+
+	AllTargets.Add(RenderTarget);
+	++NumCreated;
+	return RenderTarget;
+}
+
+void FDocGenRenderTargetPool::Release(UTextureRenderTarget2D* RenderTarget)
+{
+	check(AllTargets.Contains(RenderTarget));
+	const FBucketKey Key {FIntPoint(RenderTarget->SizeX, RenderTarget->SizeY), RenderTarget->GetFormat()};
+	FreeTargets.FindOrAdd(Key).Add(RenderTarget);
+}
+
+void FDocGenRenderTargetPool::Empty()
+{
+	for (UTextureRenderTarget2D* RenderTarget : AllTargets)
+	{
+		RenderTarget->RemoveFromRoot();
+	}
+	AllTargets.Empty();
+	FreeTargets.Empty();
+}
@@ -0,0 +1,47 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PixelFormat.h"
+
+class UTextureRenderTarget2D;
+
+// Render targets reused across node snapshots, bucketed by size so any node fits in a previously created target.
+// Pooled targets are rooted until Empty() is called. Game thread only.
+class FDocGenRenderTargetPool
+{
+public:
+	~FDocGenRenderTargetPool();
+
+	// Returns a render target at least MinSize big. Only the top left MinSize rect is meant to be used.
+	// Reused targets still hold their previous content, they are only cleared by the next draw (FWidgetRenderer clears
+	// the whole target by default).
+	UTextureRenderTarget2D* Acquire(FIntPoint MinSize, EPixelFormat Format);
+	void Release(UTextureRenderTarget2D* RenderTarget);
+	void Empty();
+
+	int32 GetNumCreated() const { return NumCreated; }
+	int32 GetNumReused() const { return NumReused; }
+
+	static FIntPoint GetBucketSize(FIntPoint MinSize);
+
+private:
+	struct FBucketKey
+	{
+		FIntPoint Size;
+		EPixelFormat Format;
+
+		bool operator==(const FBucketKey& Other) const { return Size == Other.Size && Format == Other.Format; }
+		friend uint32 GetTypeHash(const FBucketKey& Key) { return HashCombine(GetTypeHash(Key.Size), (uint32) Key.Format); }
+	};
+
+	TMap<FBucketKey, TArray<UTextureRenderTarget2D*>> FreeTargets;
+	TSet<UTextureRenderTarget2D*> AllTargets;
+	int32 NumCreated = 0;
+	int32 NumReused = 0;
+};
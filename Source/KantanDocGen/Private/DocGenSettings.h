@@ -44,6 +44,10 @@ public:
 	UPROPERTY() // EditAnywhere, Category = "Class Search")
 	TArray<FName> SpecificClasses;
 
+	/** Also document the structs and enums used by the members of SpecificClasses, recursively. */
+	UPROPERTY() // EditAnywhere, Category = "Class Search")
+	bool bIncludeSpecificClassDependencies;
+
 	/** Names of specific classes/blueprints to exclude. */
 	UPROPERTY() // EditAnywhere, Category = "Class Search")
 	TArray<FName> ExcludedClasses;
@@ -67,11 +71,58 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Output")
 	bool bCleanOutputDirectory;
 
+	/** Document inherited properties and events once, on the type declaring them. Subclasses only reference them. */
+	UPROPERTY(EditAnywhere, Category = "Output", AdvancedDisplay)
+	bool bDeduplicateInheritedMembers;
+
+	/** Number of nodes spawned and rendered per visit to the game thread. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay,
+			  Meta = (ClampMin = "1", UIMin = "1", UIMax = "256"))
+	int32 NodeBatchSize;
+
+	/** Build the blueprint actions of the documented types only, instead of the actions of every class and asset. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay)
+	bool bTargetedActionRegistration;
+
+	/** Number of content blueprints loaded asynchronously ahead of the one being documented. 0 loads them one at a time. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay,
+			  Meta = (ClampMin = "0", UIMin = "0", UIMax = "64"))
+	int32 ContentPrefetchWindow;
+
+	/** Reuse node images rendered by previous runs (cached in Intermediate/KantanDocGen/ImageCache) when nothing about the node changed. Images are keyed on the engine version, the editor style and the node title, color and pins. Other changes to how nodes are drawn (e.g. a custom node widget) aren't detected, delete the cache directory after making them. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay)
+	bool bUseImageCache;
+
+	/** Only regenerate the docs of the types that changed since the previous run. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay)
+	bool bIncrementalBuild;
+
+	/** Render each batch of nodes into a few large atlases instead of one render target per node. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay)
+	bool bUseAtlasRendering;
+
+	/** Write the docs of each type as soon as nothing can be added to them and release them, instead of keeping every doc in memory until the end. Structs and enums are written during the node pass, classes once every source has been enumerated. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay)
+	bool bStreamingFinalize;
+
+	/** When set, timings and counts of the run are saved to this file as a JSON report (see the -benchmark switch of the commandlet). */
+	UPROPERTY(Transient)
+	FString BenchmarkReportPath;
+
 public:
 	FKantanDocGenSettings()
 	{
 		BlueprintContextClass = AActor::StaticClass();
+		bIncludeSpecificClassDependencies = false;
 		bCleanOutputDirectory = false;
+		bDeduplicateInheritedMembers = false;
+		NodeBatchSize = 32;
+		ContentPrefetchWindow = 8;
+		bTargetedActionRegistration = false;
+		bUseImageCache = false;
+		bIncrementalBuild = false;
+		bUseAtlasRendering = false;
+		bStreamingFinalize = false;
 	}
 
 	bool HasAnySources() const
@@ -0,0 +1,139 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "DocGenStats.h"
+#include "DocGenSettings.h"
+#include "HAL/PlatformMemory.h"
+#include "Interfaces/IPluginManager.h"
+#include "Json.h"
+#include "KantanDocGenLog.h"
+#include "Misc/DateTime.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "OutputFormats/DocGenOutputFormatFactoryBase.h"
+#include "ThreadingHelpers.h"
+
+namespace
+{
+	// Bump this when the layout of the report changes, so tools comparing reports can tell
+	const int32 ReportVersion = 3;
+
+	TSharedRef<FJsonObject> MakeSettingsObject(const FKantanDocGenSettings& Settings)
+	{
+		TArray<TSharedPtr<FJsonValue>> NativeModules;
+		for (const FName& Module : Settings.NativeModules)
+		{
+			NativeModules.Add(MakeShared<FJsonValueString>(Module.ToString()));
+		}
+
+		TArray<TSharedPtr<FJsonValue>> ContentPaths;
+		for (const FDirectoryPath& Path : Settings.ContentPaths)
+		{
+			ContentPaths.Add(MakeShared<FJsonValueString>(Path.Path));
+		}
+
+		TArray<TSharedPtr<FJsonValue>> SpecificClasses;
+		for (const FName& Class : Settings.SpecificClasses)
+		{
+			SpecificClasses.Add(MakeShared<FJsonValueString>(Class.ToString()));
+		}
+
+		TArray<TSharedPtr<FJsonValue>> Formats;
+		for (UDocGenOutputFormatFactoryBase* Factory : Settings.OutputFormats)
+		{
+			if (Factory)
+			{
+				Formats.Add(MakeShared<FJsonValueString>(Factory->GetFormatIdentifier()));
+			}
+		}
+
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetArrayField(TEXT("native_modules"), NativeModules);
+		Object->SetArrayField(TEXT("content_paths"), ContentPaths);
+		Object->SetArrayField(TEXT("specific_classes"), SpecificClasses);
+		Object->SetBoolField(TEXT("include_dependencies"), Settings.bIncludeSpecificClassDependencies);
+		Object->SetArrayField(TEXT("formats"), Formats);
+		Object->SetNumberField(TEXT("node_batch_size"), Settings.NodeBatchSize);
+		Object->SetNumberField(TEXT("content_prefetch_window"), Settings.ContentPrefetchWindow);
+		Object->SetBoolField(TEXT("targeted_actions"), Settings.bTargetedActionRegistration);
+		Object->SetBoolField(TEXT("image_cache"), Settings.bUseImageCache);
+		Object->SetBoolField(TEXT("incremental"), Settings.bIncrementalBuild);
+		Object->SetBoolField(TEXT("atlas"), Settings.bUseAtlasRendering);
+		Object->SetBoolField(TEXT("streaming_finalize"), Settings.bStreamingFinalize);
+		Object->SetBoolField(TEXT("dedup_inherited_members"), Settings.bDeduplicateInheritedMembers);
+		return Object;
+	}
+} // namespace
+
+bool FDocGenStats::SaveReport(const FString& Path, const FKantanDocGenSettings& Settings) const
+{
+	TSharedRef<FJsonObject> OutputProcessors = MakeShared<FJsonObject>();
+	for (const auto& Pair : OutputProcessorTimes)
+	{
+		OutputProcessors->SetNumberField(Pair.Key, Pair.Value);
+	}
+
+	TSharedRef<FJsonObject> WallTimes = MakeShared<FJsonObject>();
+	WallTimes->SetNumberField(TEXT("total"), TotalTime);
+	WallTimes->SetNumberField(TEXT("node_pass"), NodePassTime);
+	WallTimes->SetNumberField(TEXT("type_members"), TypeMembersTime);
+	WallTimes->SetNumberField(TEXT("finalize"), FinalizeTime);
+	WallTimes->SetNumberField(TEXT("image_write_wait"), ImageWriteWaitTime);
+	WallTimes->SetNumberField(TEXT("game_thread_wait"), GameThreadWaitTime);
+	WallTimes->SetObjectField(TEXT("output_processors"), OutputProcessors);
+
+	TSharedRef<FJsonObject> ThreadTimes = MakeShared<FJsonObject>();
+	ThreadTimes->SetNumberField(TEXT("enumeration"), DocGenThreads::CyclesToSeconds(EnumerationCycles));
+	ThreadTimes->SetNumberField(TEXT("content_load_stall"), DocGenThreads::CyclesToSeconds(ContentLoadStallCycles));
+	ThreadTimes->SetNumberField(TEXT("spawning"), DocGenThreads::CyclesToSeconds(SpawningCycles));
+	ThreadTimes->SetNumberField(TEXT("rendering"), RenderingTime);
+	ThreadTimes->SetNumberField(TEXT("image_write"), ImageWriteTime);
+	ThreadTimes->SetNumberField(TEXT("node_docs"), NodeDocsTime);
+	ThreadTimes->SetNumberField(TEXT("serialization"), SerializationTime);
+
+	TSharedRef<FJsonObject> Counts = MakeShared<FJsonObject>();
+	Counts->SetNumberField(TEXT("nodes"), NumNodes);
+	Counts->SetNumberField(TEXT("failed_nodes"), NumFailedNodes);
+	Counts->SetNumberField(TEXT("types"), NumTypes);
+	Counts->SetNumberField(TEXT("up_to_date_types"), NumUpToDateTypes);
+	Counts->SetNumberField(TEXT("failed_images"), NumFailedImages);
+	Counts->SetNumberField(TEXT("image_cache_hits"), NumImageCacheHits);
+	Counts->SetNumberField(TEXT("image_cache_misses"), NumImageCacheMisses);
+	Counts->SetNumberField(TEXT("field_cache_hits"), NumFieldCacheHits);
+	Counts->SetNumberField(TEXT("field_cache_misses"), NumFieldCacheMisses);
+	Counts->SetNumberField(TEXT("game_thread_handoffs"), NumGameThreadHandoffs);
+	Counts->SetNumberField(TEXT("actions_built"), NumBuiltActions);
+	Counts->SetNumberField(TEXT("actions_used"), NumUsedActions);
+
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	TSharedRef<FJsonObject> Memory = MakeShared<FJsonObject>();
+	Memory->SetNumberField(TEXT("peak_used_physical"), (double) MemoryStats.PeakUsedPhysical);
+	Memory->SetNumberField(TEXT("peak_used_virtual"), (double) MemoryStats.PeakUsedVirtual);
+
+	TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("KantanDocGen"));
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetNumberField(TEXT("version"), ReportVersion);
+	Root->SetStringField(TEXT("date"), FDateTime::UtcNow().ToIso8601());
+	Root->SetStringField(TEXT("engine_version"), FEngineVersion::Current().ToString());
+	Root->SetStringField(TEXT("plugin_version"), Plugin.IsValid() ? Plugin->GetDescriptor().VersionName : FString());
+	Root->SetObjectField(TEXT("settings"), MakeSettingsObject(Settings));
+	Root->SetObjectField(TEXT("wall_time"), WallTimes);
+	Root->SetObjectField(TEXT("thread_time"), ThreadTimes);
+	Root->SetObjectField(TEXT("counts"), Counts);
+	Root->SetObjectField(TEXT("memory"), Memory);
+
+	FString Content;
+	if (!FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Content)) ||
+		!FFileHelper::SaveStringToFile(Content, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to save benchmark report %s"), *Path);
+		return false;
+	}
+
+	UE_LOG(LogKantanDocGen, Display, TEXT("Benchmark report saved to %s"), *Path);
+	return true;
+}
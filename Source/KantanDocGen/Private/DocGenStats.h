@@ -0,0 +1,55 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+struct FKantanDocGenSettings;
+
+// Timings and counts of one doc generation run, saved as a JSON report by benchmark runs.
+// Stages running on several threads report the time accumulated across threads, which may exceed the wall time.
+struct FDocGenStats
+{
+	// Game thread
+	std::atomic<uint64> EnumerationCycles {0};
+	std::atomic<uint64> SpawningCycles {0};
+	// Part of the enumeration spent waiting on content blueprints still being loaded
+	std::atomic<uint64> ContentLoadStallCycles {0};
+
+	// Wall times, in seconds
+	double TotalTime = 0.0;
+	double NodePassTime = 0.0;
+	double TypeMembersTime = 0.0;
+	double FinalizeTime = 0.0;
+	double ImageWriteWaitTime = 0.0;
+	double GameThreadWaitTime = 0.0;
+	TArray<TPair<FString, double>> OutputProcessorTimes;
+
+	// Accumulated across threads, in seconds
+	double RenderingTime = 0.0;
+	double ImageWriteTime = 0.0;
+	double NodeDocsTime = 0.0;
+	double SerializationTime = 0.0;
+
+	int32 NumNodes = 0;
+	int32 NumFailedNodes = 0;
+	int32 NumTypes = 0;
+	int32 NumUpToDateTypes = 0;
+	int32 NumFailedImages = 0;
+	int32 NumImageCacheHits = 0;
+	int32 NumImageCacheMisses = 0;
+	int32 NumFieldCacheHits = 0;
+	int32 NumFieldCacheMisses = 0;
+	int32 NumGameThreadHandoffs = 0;
+	// Blueprint node spawners built for the run, and the ones belonging to documented types
+	int32 NumBuiltActions = 0;
+	int32 NumUsedActions = 0;
+
+	bool SaveReport(const FString& Path, const FKantanDocGenSettings& Settings) const;
+};
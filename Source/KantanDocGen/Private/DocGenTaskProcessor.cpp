@@ -5,14 +5,21 @@
 // Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
 
 #include "DocGenTaskProcessor.h"
+#include "DocGenFieldCache.h"
+#include "DocGenImageCache.h"
+#include "DocGenManifest.h"
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
 #include "Async/TaskGraphInterfaces.h"
 #include "BlueprintActionDatabase.h"
 #include "BlueprintNodeSpawner.h"
+#include "DocGenHelper.h"
+#include "DocTreeNode.h"
 #include "Enumeration/CompositeEnumerator.h"
 #include "Enumeration/ContentPathEnumerator.h"
 #include "Enumeration/ISourceObjectEnumerator.h"
 #include "Enumeration/NativeModuleEnumerator.h"
+#include "Enumeration/SpecificClassEnumerator.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "HAL/FileManager.h"
 #include "HAL/PlatformProcess.h"
@@ -20,7 +27,10 @@
 #include "K2Node.h"
 #include "K2Node_Variable.h"
 #include "KantanDocGenLog.h"
+#include "KantanDocGenTrace.h"
 #include "Misc/App.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Misc/ScopeExit.h"
 #include "NodeDocsGenerator.h"
 #include "OutputFormats/DocGenOutputFormatFactoryBase.h"
 #include "OutputFormats/DocGenOutputProcessor.h"
@@ -77,8 +87,13 @@ void FDocGenTaskProcessor::Stop()
 
 void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 {
+	KANTANDOCGEN_TRACE_SCOPE(FDocGenTaskProcessor::ProcessTask);
 	Current = MakeShared<FDocGenCurrentTask>();
 	Current->Task = InTask;
+	const double StartTime = FPlatformTime::Seconds();
+	const uint64 SerializeCyclesAtStart = FDocGenHelper::SerializeDocToFileCycles.load(std::memory_order_relaxed);
+	// Fields may have been destroyed since the previous run
+	FDocGenFieldCache::Get().Reset();
 	/********** Lambdas for the game thread to execute **********/
 
 	auto GameThread_InitDocGen = [Current = this->Current](FString const& DocTitle,
@@ -93,23 +108,118 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 	};
 
 	TFunction<void()> GameThread_EnqueueEnumerators = [Current = this->Current]() {
-		// @TODO: Specific class enumerator
-		Current->Enumerators.Enqueue(
-			MakeShared<FCompositeEnumerator<FNativeModuleEnumerator>>(Current->Task->Settings.NativeModules));
+		if (Current->Task->Settings.bTargetedActionRegistration)
+		{
+			Current->ActionCollector = MakeUnique<FDocGenActionCollector>();
+		}
+		else
+		{
+			// First access builds the actions of every class and asset
+			for (auto const& Pair : FBlueprintActionDatabase::Get().GetAllActions())
+			{
+				Current->Stats.NumBuiltActions += Pair.Value.Num();
+			}
+		}
+
+		if (Current->Task->Settings.SpecificClasses.Num() > 0)
+		{
+			Current->Enumerators.Enqueue(MakeShared<FSpecificClassEnumerator>(
+				Current->Task->Settings.SpecificClasses, Current->Task->Settings.bIncludeSpecificClassDependencies));
+		}
+
+		Current->Enumerators.Enqueue(MakeShared<FNativeModuleEnumerator>(Current->Task->Settings.NativeModules));
 
 		TArray<FName> ContentPackagePaths;
 		for (auto const& Path : Current->Task->Settings.ContentPaths)
 		{
 			ContentPackagePaths.AddUnique(FName(*Path.Path));
 		}
-		Current->Enumerators.Enqueue(MakeShared<FCompositeEnumerator<FContentPathEnumerator>>(ContentPackagePaths));
+		Current->Enumerators.Enqueue(MakeShared<FCompositeEnumerator<FContentPathEnumerator>>(
+			ContentPackagePaths, Current->Task->Settings.ExcludedClasses, Current->Task->Settings.ContentPrefetchWindow,
+			&Current->Stats.ContentLoadStallCycles));
+	};
+
+	// Incremental builds: when a class is regenerated, the nodes that other sources added to it in the previous run must
+	// be spawned again. The up to date ones that were already skipped are enumerated again once the enumerators are done.
+	auto GameThread_RevisitSource = [this](const FString& SourceDocDir) {
+		Current->SourcesToRevisit.Add(SourceDocDir);
+		if (Current->SkippedSources.Remove(SourceDocDir) == 0)
+		{
+			return;
+		}
+		if (UObject* Source = Current->UpToDateSources.FindRef(SourceDocDir).Get())
+		{
+			Current->Processed.Remove(Source);
+			Current->Enumerated.Remove(Source);
+			Current->RevisitedSources.Add(Source);
+			Current->LateSources.Add(FName(*Source->GetPathName()));
+		}
+	};
+
+	auto GameThread_InvalidateType = [this, GameThread_RevisitSource](const FString& TypeDocDir) {
+		bool bAlreadyInvalidated = false;
+		Current->InvalidatedTypeDirs.Add(TypeDocDir, &bAlreadyInvalidated);
+		if (bAlreadyInvalidated)
+		{
+			return;
+		}
+
+		if (UObject* Source = Current->UpToDateSources.FindRef(TypeDocDir).Get())
+		{
+			Current->DocGen->GT_MarkTypeOutdated(FDocGenManifest::GetDocumentedType(Source));
+		}
+		GameThread_RevisitSource(TypeDocDir);
+		for (const FString& Contributor : Current->PreviousManifest->FindContributors(TypeDocDir))
+		{
+			GameThread_RevisitSource(Contributor);
+		}
+	};
+
+	// Nodes are only skipped if the docs of their class are up to date and their source didn't change. Any other node
+	// means its class is regenerated.
+	auto GameThread_ShouldDocumentNodes = [this, GameThread_InvalidateType](UClass* AssociatedClass,
+																			UObject* SourceObject) -> bool {
+		const FString TargetDocDir = Current->DocGen->GetTypeDocDirectory(AssociatedClass);
+		if (TargetDocDir.IsEmpty())
+		{
+			return true;
+		}
+		if (!Current->SourceDocDir.IsEmpty() && Current->SourceDocDir != TargetDocDir)
+		{
+			Current->Manifest->AddContribution(Current->SourceDocDir, TargetDocDir);
+		}
+		if (!Current->PreviousManifest.IsValid())
+		{
+			return true;
+		}
+
+		if (!Current->bSourceChanged && Current->DocGen->GT_IsTypeUpToDate(AssociatedClass))
+		{
+			return false;
+		}
+		GameThread_InvalidateType(TargetDocDir);
+		return true;
 	};
 
-	auto GameThread_EnumerateNextObject = [this]() -> bool {
+	auto GameThread_EnqueueRevisitedSources = [this]() -> bool {
+		if (Current->LateSources.Num() == 0)
+		{
+			return false;
+		}
+		UE_LOG(LogKantanDocGen, Display, TEXT("Enumerating %d up to date sources again, they add nodes to regenerated classes."),
+			   Current->LateSources.Num());
+		Current->Enumerators.Enqueue(MakeShared<FSpecificClassEnumerator>(Current->LateSources));
+		Current->LateSources.Reset();
+		return true;
+	};
+
+	auto GameThread_EnumerateNextObject = [this, GameThread_InvalidateType]() -> bool {
+		KANTANDOCGEN_TRACE_SCOPE(GameThread_EnumerateNextObject);
+		DocGenThreads::FScopedCycleAccumulator CycleCounter(Current->Stats.EnumerationCycles);
 		Current->SourceObject.Reset();
 		Current->CurrentSpawners.Empty();
 
-		while (auto Obj = Current->CurrentEnumerator->GetNext())
+		while (auto Obj = Current->CurrentEnumerator->GetNextUnique(Current->Enumerated))
 		{
 			UE_LOG(LogKantanDocGen, Display, TEXT("Enumerating object %s"), *Obj->GetName());
 			// Ignore if already processed
@@ -118,25 +228,88 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 				continue;
 			}
 			Current->SourceObject = Obj;
-			Current->TypesToParseForMembers.Add(Obj);
-			// Cache list of spawners for this object
-			auto& BPActionMap = FBlueprintActionDatabase::Get().GetAllActions();
-			if (auto ActionList = BPActionMap.Find(Obj))
+			// Revisited sources were listed the first time they were enumerated
+			if (!Current->RevisitedSources.Contains(Obj))
+			{
+				Current->TypesToParseForMembers.Add(Obj);
+			}
+
+			if (Current->Manifest.IsValid())
 			{
-				if (ActionList->Num() == 0)
+				UObject* DocumentedType = FDocGenManifest::GetDocumentedType(Obj);
+				const FString TypeDocDir = Current->DocGen->GetTypeDocDirectory(DocumentedType);
+				Current->SourceDocDir = TypeDocDir;
+				Current->bSourceChanged = true;
+				if (!TypeDocDir.IsEmpty())
 				{
-					continue;
+					const FString Fingerprint = Current->Manifest->ComputeTypeFingerprint(DocumentedType);
+					Current->Manifest->SetTypeFingerprint(TypeDocDir, Fingerprint);
+
+					if (Current->PreviousManifest.IsValid())
+					{
+						const FString* PreviousFingerprint = Current->PreviousManifest->FindTypeFingerprint(TypeDocDir);
+						Current->bSourceChanged = !PreviousFingerprint || *PreviousFingerprint != Fingerprint;
+						if (!Current->bSourceChanged && !Current->InvalidatedTypeDirs.Contains(TypeDocDir))
+						{
+							// Docs from the previous run are still valid
+							Current->DocGen->GT_MarkTypeUpToDate(DocumentedType);
+							Current->UpToDateSources.Add(TypeDocDir, Obj);
+							if (!Current->SourcesToRevisit.Contains(TypeDocDir))
+							{
+								Current->SkippedSources.Add(TypeDocDir);
+								Current->Processed.Add(Obj);
+								continue;
+							}
+						}
+						else
+						{
+							// Stale files of regenerated types are only deleted once the run is over, as other sources
+							// may have already written node docs in their directory.
+							GameThread_InvalidateType(TypeDocDir);
+							if (Current->bSourceChanged)
+							{
+								// It may not add nodes to these classes anymore
+								for (const FString& Target : Current->PreviousManifest->FindContributionTargets(TypeDocDir))
+								{
+									GameThread_InvalidateType(Target);
+								}
+							}
+						}
+					}
+				}
+			}
+			// Cache list of spawners for this object
+			auto EnqueueSpawners = [this, Obj](auto const& ActionList) -> bool {
+				if (ActionList.Num() == 0)
+				{
+					return false;
 				}
 
-				for (auto Spawner : *ActionList)
+				for (auto Spawner : ActionList)
 				{
 					// Add to queue as weak ptr
 					check(Current->CurrentSpawners.Enqueue(Spawner));
 				}
+				Current->Stats.NumUsedActions += ActionList.Num();
 
 				// Done
 				Current->Processed.Add(Obj);
 				return true;
+			};
+
+			if (Current->ActionCollector.IsValid())
+			{
+				if (EnqueueSpawners(Current->ActionCollector->GetActions(Obj)))
+				{
+					return true;
+				}
+			}
+			else if (auto ActionList = FBlueprintActionDatabase::Get().GetAllActions().Find(Obj))
+			{
+				if (EnqueueSpawners(*ActionList))
+				{
+					return true;
+				}
 			}
 		}
 
@@ -144,37 +317,58 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 		return false;
 	};
 
-	auto GameThread_EnumerateNextNode = [this](FNodeDocsGenerator::FNodeProcessingState& OutState) -> UK2Node* {
+	auto GameThread_EnumerateNextNodes = [this](TArray<FNodeDocsGenerator::FSpawnedNode>& OutBatch,
+												int32 BatchSize) -> int32 {
+		KANTANDOCGEN_TRACE_SCOPE(GameThread_EnumerateNextNodes);
 		// We've just come in from another thread, check the source object is still around
 		if (!Current->SourceObject.IsValid())
 		{
 			UE_LOG(LogKantanDocGen, Warning, TEXT("Object being enumerated expired!"));
-			return nullptr;
+			return 0;
 		}
 
-		// Try to grab the next spawner in the cached list
-		TWeakObjectPtr<UBlueprintNodeSpawner> Spawner;
-		while (Current->CurrentSpawners.Dequeue(Spawner))
+		// Spawn and render up to BatchSize nodes from the cached list, so a single game thread visit serves many nodes.
+		// Keep going if a whole batch failed, an empty batch means this object is done.
+		while (OutBatch.Num() == 0 && !Current->CurrentSpawners.IsEmpty())
 		{
-			if (Spawner.IsValid())
 			{
-				// See if we can document this spawner
-				auto K2_NodeInst =
-					Current->DocGen->GT_InitializeForSpawner(Spawner.Get(), Current->SourceObject.Get(), OutState);
-
-				if (K2_NodeInst == nullptr)
+				DocGenThreads::FScopedCycleAccumulator CycleCounter(Current->Stats.SpawningCycles);
+				TWeakObjectPtr<UBlueprintNodeSpawner> Spawner;
+				while (OutBatch.Num() < BatchSize && Current->CurrentSpawners.Dequeue(Spawner))
 				{
-					continue;
-				}
+					if (!Spawner.IsValid())
+					{
+						continue;
+					}
+
+					FNodeDocsGenerator::FSpawnedNode& Spawned = OutBatch.AddDefaulted_GetRef();
+
+					// See if we can document this spawner
+					Spawned.Node =
+						Current->DocGen->GT_InitializeForSpawner(Spawner.Get(), Current->SourceObject.Get(), Spawned.State);
 
-				// Make sure this node object will never be GCd until we're done with it.
-				K2_NodeInst->AddToRoot();
-				return K2_NodeInst;
+					if (Spawned.Node == nullptr)
+					{
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+						OutBatch.Pop(false);
+#else
+						OutBatch.Pop(EAllowShrinking::No);
+#endif
+						continue;
+					}
+
+					// Make sure this node object will never be GCd until we're done with it.
+					Spawned.Node->AddToRoot();
+				}
 			}
+
+			// Render the node images now that we're on the game thread anyway
+			Current->DocGen->GT_RenderNodeImages(OutBatch, Current->Task->Settings.bUseAtlasRendering);
+			// Workers complete in any order, the class docs list the nodes in spawn order
+			Current->DocGen->GT_ReserveClassDocEntries(OutBatch);
 		}
 
-		// No spawners left in the queue
-		return nullptr;
+		return OutBatch.Num();
 	};
 
 	auto GameThread_FinalizeDocs = [this](FString const& OutputPath) -> bool {
@@ -203,7 +397,16 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 	EnqueueEnumeratorsResult.Get();
 
 	// Initialize the doc generator
-	Current->DocGen = MakeUnique<FNodeDocsGenerator>(Current->Task->Settings.OutputFormats, Current->Task->Settings.CustomMetaKeys);
+	Current->DocGen = MakeUnique<FNodeDocsGenerator>(Current->Task->Settings.OutputFormats, Current->Task->Settings.CustomMetaKeys,
+													   Current->Task->Settings.bDeduplicateInheritedMembers);
+	if (Current->Task->Settings.bUseImageCache)
+	{
+		Current->DocGen->EnableImageCache(FDocGenImageCache::GetDefaultCacheDir());
+	}
+	if (Current->Task->Settings.bIncrementalBuild)
+	{
+		Current->DocGen->SetNodeFilter(GameThread_ShouldDocumentNodes);
+	}
 
 	auto InitDocGenResult = Async(
 		EAsyncExecution::TaskGraphMainThread, [GameThread_InitDocGen, Current = this->Current, IntermediateDir]() {
@@ -216,23 +419,131 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 		return;
 	}
 
-	bool const bCleanIntermediate = true;
+	Current->IntermediateDir = IntermediateDir;
+	const FString ManifestPath = IntermediateDir + TEXT(".manifest.json");
+	if (Current->Task->Settings.bIncrementalBuild)
+	{
+		Current->Manifest = MakeShared<FDocGenManifest>();
+		Current->Manifest->SetSettingsFingerprint(FDocGenManifest::ComputeSettingsFingerprint(Current->Task->Settings));
+
+		TSharedPtr<FDocGenManifest> PreviousManifest = MakeShared<FDocGenManifest>();
+		if (IFileManager::Get().DirectoryExists(*IntermediateDir) && PreviousManifest->Load(ManifestPath) &&
+			PreviousManifest->GetSettingsFingerprint() == Current->Manifest->GetSettingsFingerprint())
+		{
+			Current->PreviousManifest = PreviousManifest;
+			UE_LOG(LogKantanDocGen, Display, TEXT("Incremental build, %d types documented by the previous run."),
+				   PreviousManifest->GetTypeFingerprints().Num());
+		}
+		else
+		{
+			UE_LOG(LogKantanDocGen, Display,
+				   TEXT("No usable manifest from a previous run (or settings changed), doing a full build."));
+		}
+
+		// Only written back once this run succeeded, the intermediate docs are about to be modified
+		IFileManager::Get().Delete(*ManifestPath, false, true, true);
+	}
+
+	const bool bCleanIntermediate = !Current->PreviousManifest.IsValid();
 	if (bCleanIntermediate)
 	{
 		IFileManager::Get().DeleteDirectory(*IntermediateDir, false, true);
 	}
+	else
+	{
+		FDocGenHelper::BeginRecordingWrittenFiles();
+	}
+	ON_SCOPE_EXIT
+	{
+		FDocGenHelper::EndRecordingWrittenFiles();
+	};
 
 	for (auto const& Name : Current->Task->Settings.ExcludedClasses)
 	{
 		Current->Excluded.Add(Name);
 	}
 
-	int SuccessfulNodeCount = 0;
-	while (Current->Enumerators.Dequeue(Current->CurrentEnumerator))
+	const int32 NodeBatchSize = FMath::Max(1, Current->Task->Settings.NodeBatchSize);
+
+	// Only spawning and rendering nodes has to happen on the game thread. Saving the node images (through the engine
+	// image write queue) and building and serializing the node docs (on the thread pool) are independent stages.
+	// Each stage is bounded, so the game thread stops spawning when the workers fall behind (this also caps the
+	// memory held by rendered pixels).
+	const int32 MaxPendingPerStage = FMath::Max(2 * NodeBatchSize, 2 * FTaskGraphInterface::Get().GetNumWorkerThreads());
+	DocGenThreads::FBoundedTaskQueue ImageStage(MaxPendingPerStage);
+	DocGenThreads::FBoundedTaskQueue DocStage(MaxPendingPerStage);
+	FNodeDocsGenerator* DocGen = Current->DocGen.Get();
+	FDocGenStats& Stats = Current->Stats;
+	// On every exit path (termination, failures), nothing may still be writing docs once the task is over. The stages
+	// join their node docs and images when destroyed.
+	ON_SCOPE_EXIT
+	{
+		DocGen->WaitForDocWrites();
+	};
+
+	// Types are independent, their members are prepared in parallel. Only adding them to the doc files (and the index)
+	// is serialized, in enumeration order.
+	bool bTypeMembersFailed = false;
+	auto GenerateTypeMembers = [DocGen, &bTypeMembersFailed](TConstArrayView<TWeakObjectPtr<UObject>> Types) {
+		KANTANDOCGEN_TRACE_SCOPE(GenerateTypeMembers);
+		TArray<TSharedPtr<DocTreeNode>> DocTrees;
+		DocTrees.SetNum(Types.Num());
+		ParallelFor(Types.Num(), [DocGen, Types, &DocTrees](int32 Index) {
+			DocTrees[Index] = DocGen->PrepareTypeMembers(Types[Index].Get());
+		});
+		for (int32 Index = 0; Index < Types.Num(); ++Index)
+		{
+			if (!DocGen->CommitTypeMembers(Types[Index].Get(), MoveTemp(DocTrees[Index])))
+			{
+				bTypeMembersFailed = true;
+			}
+		}
+	};
+
+	// Streaming finalize: the docs of a type are written (and released) as soon as nothing can be added to them anymore,
+	// so that the trees of every type aren't all held in memory at the same time. Any source enumerated later may
+	// spawn nodes for a class (e.g. calls to its functions), so classes are only released once every source has been
+	// enumerated. Structs and enums never get nodes, they are released right away.
+	const bool bStreamingFinalize = Current->Task->Settings.bStreamingFinalize;
+	TArray<TWeakObjectPtr<UObject>> PendingTypeDocs;
+	int32 NumTypesQueuedForRelease = 0;
+	int32 NumTypesReleased = 0;
+	auto ReleaseCompletedTypeDocs = [this, &PendingTypeDocs, &NumTypesQueuedForRelease, &NumTypesReleased, &Stats,
+									 &GenerateTypeMembers](bool bEnumerationDone) {
+		// Types enumerated so far, including the ones without any node
+		for (; NumTypesQueuedForRelease < Current->TypesToParseForMembers.Num(); ++NumTypesQueuedForRelease)
+		{
+			PendingTypeDocs.Add(Current->TypesToParseForMembers[NumTypesQueuedForRelease]);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		TArray<TWeakObjectPtr<UObject>> CompletedTypes;
+		PendingTypeDocs.RemoveAll([bEnumerationDone, &CompletedTypes](const TWeakObjectPtr<UObject>& Type) {
+			if (bEnumerationDone || !Cast<UClass>(FDocGenManifest::GetDocumentedType(Type.Get())))
+			{
+				CompletedTypes.Add(Type);
+				return true;
+			}
+			return false;
+		});
+
+		GenerateTypeMembers(CompletedTypes);
+		for (const TWeakObjectPtr<UObject>& Type : CompletedTypes)
+		{
+			Current->DocGen->ReleaseTypeDocs(Type.Get());
+		}
+		NumTypesReleased += CompletedTypes.Num();
+		Stats.TypeMembersTime += FPlatformTime::Seconds() - StartTime;
+	};
+
+	const double NodePassStartTime = FPlatformTime::Seconds();
+	while (Current->Enumerators.Dequeue(Current->CurrentEnumerator) ||
+		   (DocGenThreads::RunOnGameThreadTracked(Current->HandoffStats, GameThread_EnqueueRevisitedSources) &&
+			Current->Enumerators.Dequeue(Current->CurrentEnumerator)))
 	{
-		while (Async(EAsyncExecution::TaskGraphMainThread, [GameThread_EnumerateNextObject]() {
+		while (DocGenThreads::RunOnGameThreadTracked(Current->HandoffStats, [GameThread_EnumerateNextObject]() {
 				   return GameThread_EnumerateNextObject();
-			   }).Get()) // Game thread: Enumerate next Obj, get spawner list for Obj, store as
+			   })) // Game thread: Enumerate next Obj, get spawner list for Obj, store as
 						 // array of weak ptrs.
 		{
 			if (bTerminationRequest)
@@ -240,52 +551,163 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 				return;
 			}
 
-			FNodeDocsGenerator::FNodeProcessingState NodeState;
-			while (auto NodeInst =
-					   Async(EAsyncExecution::TaskGraphMainThread, [&NodeState, GameThread_EnumerateNextNode]() {
-						   return GameThread_EnumerateNextNode(NodeState);
-					   }).Get()) // Game thread: Get next still valid spawner, spawn node, add to root, return it)
+			TArray<FNodeDocsGenerator::FSpawnedNode> NodeBatch;
+			while (DocGenThreads::RunOnGameThreadTracked(
+					   Current->HandoffStats, [&NodeBatch, NodeBatchSize, GameThread_EnumerateNextNodes]() {
+						   return GameThread_EnumerateNextNodes(NodeBatch, NodeBatchSize);
+					   }) > 0) // Game thread: Spawn and render the next batch of nodes, add them to root, return them)
 			{
-				// NodeInst should hopefully not reference anything except stuff we control (ie graph object), and
-				// it's rooted so should be safe to deal with here
-
-				// Generate image
-				if (!Current->DocGen->GenerateNodeImage(NodeInst, NodeState))
+				for (auto& Spawned : NodeBatch)
 				{
-					UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to generate node image!"))
-					continue;
-				}
+					// NodeInst should hopefully not reference anything except stuff we control (ie graph object), and
+					// it's rooted so should be safe to deal with here
+					UK2Node* NodeInst = Spawned.Node;
 
-				if (auto NodeVariableInst = Cast<UK2Node_Variable>(NodeInst))
-				{
-					// Generate doc for variables
-					if(!Current->DocGen->GenerateVariableDocTree(NodeVariableInst, NodeState))
+					// Save the image rendered on the game thread
+					if (!Spawned.State.Image.SavePath.IsEmpty())
 					{
-						UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to generate variable doc output!"))
-						continue;
-					}
-				}
-				else
-				{
-					// Generate doc
-					if (!Current->DocGen->GenerateNodeDocTree(NodeInst, NodeState))
-					{
-						UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to generate node doc output!"))
-						continue;
+						ImageStage.Add(DocGen->GenerateNodeImage(MoveTemp(Spawned.State.Image)));
 					}
+
+					TRACE_COUNTER_INCREMENT(KantanDocGen_QueuedNodes);
+					DocStage.Add(Async(EAsyncExecution::ThreadPool,
+									   [DocGen, NodeInst, NodeState = MoveTemp(Spawned.State)]() mutable {
+										   KANTANDOCGEN_TRACE_SCOPE(GenerateNodeDocs);
+										   ON_SCOPE_EXIT
+										   {
+											   TRACE_COUNTER_DECREMENT(KantanDocGen_QueuedNodes);
+										   };
+										   if (auto NodeVariableInst = Cast<UK2Node_Variable>(NodeInst))
+										   {
+											   // Generate doc for variables
+											   if (!DocGen->GenerateVariableDocTree(NodeVariableInst, NodeState))
+											   {
+												   UE_LOG(LogKantanDocGen, Warning,
+														  TEXT("Failed to generate variable doc output!"))
+												   return false;
+											   }
+										   }
+										   else
+										   {
+											   // Generate doc
+											   if (!DocGen->GenerateNodeDocTree(NodeInst, NodeState))
+											   {
+												   UE_LOG(LogKantanDocGen, Warning,
+														  TEXT("Failed to generate node doc output!"))
+												   return false;
+											   }
+										   }
+										   return true;
+									   }));
 				}
-				++SuccessfulNodeCount;
+				NodeBatch.Reset();
+			}
+
+			if (bStreamingFinalize)
+			{
+				ReleaseCompletedTypeDocs(/*bEnumerationDone = */false);
 			}
 		}
 	}
-	for (const auto& Type : Current->TypesToParseForMembers)
+
+	// Everything below works on the complete class doc trees. Images are still allowed to be written in the background.
+	{
+		KANTANDOCGEN_TRACE_SCOPE(WaitForNodeDocs);
+		DocStage.WaitAll();
+	}
+	if (Current->ActionCollector.IsValid())
+	{
+		// Every node has been spawned, the actions aren't needed anymore
+		DocGenThreads::RunOnGameThread([this] {
+			Current->Stats.NumBuiltActions = Current->ActionCollector->GetNumBuilt();
+			Current->ActionCollector->Empty();
+		});
+	}
+
+	const int SuccessfulNodeCount = DocStage.GetNumSucceeded();
+	Stats.NodePassTime = FPlatformTime::Seconds() - NodePassStartTime;
+	Stats.NumNodes = SuccessfulNodeCount;
+	Stats.NumFailedNodes = DocStage.GetNumFailed();
+
+	UE_LOG(LogKantanDocGen, Display,
+		   TEXT("Documented %d nodes using %d game thread handoffs (batch size %d), %.2fs spent waiting on the game "
+				"thread."),
+		   SuccessfulNodeCount, Current->HandoffStats.NumHandoffs, NodeBatchSize, Current->HandoffStats.WaitTime);
+	UE_LOG(LogKantanDocGen, Display,
+		   TEXT("Node rendering: %.2fs, node docs: %.2fs (%.2fs stalled), image write queue: %.2fs stalled."),
+		   DocGenThreads::CyclesToSeconds(DocGen->RenderNodeImageCycles),
+		   DocGenThreads::CyclesToSeconds(DocGen->GenerateNodeDocsCycles), DocStage.GetWaitTime(),
+		   ImageStage.GetWaitTime());
+	const TCHAR* ActionSource = TEXT("action database");
+	if (Current->ActionCollector.IsValid())
+	{
+		ActionSource = Current->ActionCollector->HasUsedActionDatabase()
+						   ? TEXT("documented types, action database for K2 nodes")
+						   : TEXT("documented types only");
+	}
+	UE_LOG(LogKantanDocGen, Display, TEXT("Blueprint actions: %d built (%s), %d used."), Stats.NumBuiltActions,
+		   ActionSource, Stats.NumUsedActions);
+	UE_LOG(LogKantanDocGen, Display, TEXT("Enumeration: %.2fs, %.2fs stalled on content loads (prefetch window %d)."),
+		   DocGenThreads::CyclesToSeconds(Stats.EnumerationCycles),
+		   DocGenThreads::CyclesToSeconds(Stats.ContentLoadStallCycles), Current->Task->Settings.ContentPrefetchWindow);
+
+	if (bStreamingFinalize)
+	{
+		const int32 NumTypesReleasedDuringNodePass = NumTypesReleased;
+		ReleaseCompletedTypeDocs(/*bEnumerationDone = */true);
+		UE_LOG(LogKantanDocGen, Display, TEXT("Streaming finalize: docs of %d types written, %d during the node pass."),
+			   NumTypesReleased, NumTypesReleasedDuringNodePass);
+	}
+	else
 	{
-		Current->DocGen->GenerateTypeMembers(Type.Get());
+		const double TypeMembersStartTime = FPlatformTime::Seconds();
+		GenerateTypeMembers(Current->TypesToParseForMembers);
+		Stats.TypeMembersTime = FPlatformTime::Seconds() - TypeMembersStartTime;
+	}
+	if (bTypeMembersFailed)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to generate the docs of some types!"));
+		Async(EAsyncExecution::TaskGraphMainThread, [this] {
+			Current->Task->NotifySetText(LOCTEXT("DocFinalizationFailed", "Doc gen failed"));
+			Current->Task->NotifySetCompletionState(SNotificationItem::CS_Fail);
+			Current->Task->NotifyExpireFadeOut();
+		}, [this] { Current->Task.Reset(); }); // Free the task
+		return;
 	}
 	// TODO: Generate any other blueprint types and associated data here
 	// rather than enqueing the enumerator for other bp types, simply have one of each and deal with them here
 
-	if (SuccessfulNodeCount == 0)
+	// Directories that may hold files the previous run wrote and this one didn't, cleaned once everything is written
+	TArray<FString> StaleTypeDocDirs;
+	if (Current->PreviousManifest.IsValid())
+	{
+		// Types that are not documented anymore
+		int32 NumRemovedTypes = 0;
+		for (const auto& Pair : Current->PreviousManifest->GetTypeFingerprints())
+		{
+			if (Current->Manifest->FindTypeFingerprint(Pair.Key) == nullptr)
+			{
+				StaleTypeDocDirs.Add(Pair.Key);
+				++NumRemovedTypes;
+			}
+		}
+		StaleTypeDocDirs.Append(Current->InvalidatedTypeDirs.Array());
+
+		// Sources that weren't enumerated again still add the same nodes
+		for (const FString& SourceDocDir : Current->SkippedSources)
+		{
+			Current->Manifest->CopyContributions(*Current->PreviousManifest, SourceDocDir);
+		}
+
+		const int32 NumUpToDateTypes = DocGen->GetNumUpToDateTypes();
+		UE_LOG(LogKantanDocGen, Display,
+			   TEXT("Incremental build: %d types up to date, %d regenerated, %d removed, %d sources enumerated again."),
+			   NumUpToDateTypes, Current->Manifest->GetTypeFingerprints().Num() - NumUpToDateTypes, NumRemovedTypes,
+			   Current->RevisitedSources.Num());
+	}
+
+	// Nothing may need to be regenerated in an incremental build
+	if (SuccessfulNodeCount == 0 && DocGen->GetNumUpToDateTypes() == 0)
 	{
 		UE_LOG(LogKantanDocGen, Error, TEXT("No nodes were found to document!"));
 		Async(EAsyncExecution::TaskGraphMainThread, [this] {
@@ -299,6 +721,7 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 	}
 
 	// Game thread: DocGen.GT_Finalize()
+	const double FinalizeStartTime = FPlatformTime::Seconds();
 	auto FinalizeResult = Async(EAsyncExecution::TaskGraphMainThread, [GameThread_FinalizeDocs, IntermediateDir]() {
 		return GameThread_FinalizeDocs(IntermediateDir);
 	});
@@ -308,9 +731,58 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to finalize xml docs!"));
 		return;
 	}
+	Stats.FinalizeTime = FPlatformTime::Seconds() - FinalizeStartTime;
+
+	{
+		const FDocGenFieldCache& FieldCache = FDocGenFieldCache::Get();
+		const int32 NumLookups = FieldCache.GetNumHits() + FieldCache.GetNumMisses();
+		UE_LOG(LogKantanDocGen, Display, TEXT("Field cache: %d hits, %d misses (%.1f%% hit rate)."),
+			   FieldCache.GetNumHits(), FieldCache.GetNumMisses(),
+			   NumLookups > 0 ? 100.0 * FieldCache.GetNumHits() / NumLookups : 0.0);
+		Stats.NumFieldCacheHits = FieldCache.GetNumHits();
+		Stats.NumFieldCacheMisses = FieldCache.GetNumMisses();
+	}
+
 	Async(EAsyncExecution::TaskGraphMainThread,
 		  [this] { Current->Task->NotifySetText(LOCTEXT("DocConversionInProgress", "Converting docs")); });
 
+	// Output processors copy the node images, they must all be on disk
+	{
+		KANTANDOCGEN_TRACE_SCOPE(WaitForImageWrites);
+		const double FenceStartTime = FPlatformTime::Seconds();
+		DocGen->WaitForImageWrites();
+		ImageStage.WaitAll();
+		Stats.ImageWriteWaitTime = FPlatformTime::Seconds() - FenceStartTime;
+		Stats.NumFailedImages = ImageStage.GetNumFailed();
+		UE_LOG(LogKantanDocGen, Display, TEXT("Waited %.2fs for node images to be written (%d failed)."),
+			   Stats.ImageWriteWaitTime, Stats.NumFailedImages);
+
+		if (const FDocGenImageCache* ImageCache = DocGen->GetImageCache())
+		{
+			const int32 NumLookups = ImageCache->GetNumHits() + ImageCache->GetNumMisses();
+			UE_LOG(LogKantanDocGen, Display, TEXT("Image cache: %d hits, %d misses (%.1f%% hit rate), %d images stored."),
+				   ImageCache->GetNumHits(), ImageCache->GetNumMisses(),
+				   NumLookups > 0 ? 100.0 * ImageCache->GetNumHits() / NumLookups : 0.0, ImageCache->GetNumStored());
+			Stats.NumImageCacheHits = ImageCache->GetNumHits();
+			Stats.NumImageCacheMisses = ImageCache->GetNumMisses();
+		}
+	}
+
+	if (StaleTypeDocDirs.Num() > 0)
+	{
+		KANTANDOCGEN_TRACE_SCOPE(DeleteStaleDocs);
+		int32 NumDeletedFiles = 0;
+		for (const FString& TypeDocDir : StaleTypeDocDirs)
+		{
+			NumDeletedFiles += FDocGenHelper::DeleteFilesNotWritten(IntermediateDir / TypeDocDir);
+		}
+		UE_LOG(LogKantanDocGen, Display, TEXT("Incremental build: %d stale files deleted."), NumDeletedFiles);
+	}
+	if (Current->Manifest.IsValid())
+	{
+		Current->Manifest->Save(ManifestPath);
+	}
+
 	if (Current->Task->Settings.bCleanOutputDirectory)
 	{
 		TArray<FString> OutputDirectoryContents;
@@ -325,10 +797,14 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 	EIntermediateProcessingResult TransformationResult = Success;
 	for (const auto& OutputFormatFactory : Current->Task->Settings.OutputFormats)
 	{
+		KANTANDOCGEN_TRACE_SCOPE_TEXT(*(TEXT("OutputProcessor ") + OutputFormatFactory->GetFormatIdentifier()));
+		const double ProcessorStartTime = FPlatformTime::Seconds();
 		auto IntermediateProcessor = OutputFormatFactory->CreateIntermediateDocProcessor();
 		EIntermediateProcessingResult Result = IntermediateProcessor->ProcessIntermediateDocs(
 			IntermediateDir, Current->Task->Settings.OutputDirectory.Path, Current->Task->Settings.DocumentationTitle,
 			Current->Task->Settings.bCleanOutputDirectory);
+		Stats.OutputProcessorTimes.Emplace(OutputFormatFactory->GetFormatIdentifier(),
+										   FPlatformTime::Seconds() - ProcessorStartTime);
 
 		if (Result != EIntermediateProcessingResult::Success)
 		{
@@ -337,6 +813,22 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 		// Don't abort after performing one transformation, as others may succeed
 	}
 
+	if (!Current->Task->Settings.BenchmarkReportPath.IsEmpty())
+	{
+		Stats.TotalTime = FPlatformTime::Seconds() - StartTime;
+		Stats.GameThreadWaitTime = Current->HandoffStats.WaitTime;
+		Stats.NumGameThreadHandoffs = Current->HandoffStats.NumHandoffs;
+		Stats.NumTypes = Current->TypesToParseForMembers.Num();
+		Stats.NumUpToDateTypes = DocGen->GetNumUpToDateTypes();
+		Stats.RenderingTime = DocGenThreads::CyclesToSeconds(DocGen->RenderNodeImageCycles);
+		Stats.ImageWriteTime = DocGenThreads::CyclesToSeconds(DocGen->WriteNodeImageCycles);
+		Stats.NodeDocsTime = DocGenThreads::CyclesToSeconds(DocGen->GenerateNodeDocsCycles);
+		Stats.SerializationTime = FPlatformTime::ToSeconds64(
+			FDocGenHelper::SerializeDocToFileCycles.load(std::memory_order_relaxed) - SerializeCyclesAtStart);
+
+		Stats.SaveReport(Current->Task->Settings.BenchmarkReportPath, Current->Task->Settings);
+	}
+
 	if (TransformationResult != EIntermediateProcessingResult::Success)
 	{
 		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to transform xml to html!"));
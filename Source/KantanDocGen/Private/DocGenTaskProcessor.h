@@ -7,6 +7,9 @@
 #pragma once
 
 #include "DocGenSettings.h"
+#include "DocGenActionCollector.h"
+#include "DocGenStats.h"
+#include "ThreadingHelpers.h"
 
 #include "Containers/Queue.h"
 #include "CoreMinimal.h"
@@ -16,6 +19,7 @@
 
 class ISourceObjectEnumerator;
 class FNodeDocsGenerator;
+class FDocGenManifest;
 
 class UBlueprintNodeSpawner;
 
@@ -61,13 +65,41 @@ protected:
 		TQueue<TSharedPtr<ISourceObjectEnumerator>> Enumerators;
 		TSet<FName> Excluded;
 		TSet<TWeakObjectPtr<UObject>> Processed;
+		// Every object yielded by the enumerators so far, an object is only documented once even if several yield it
+		TSet<TWeakObjectPtr<UObject>> Enumerated;
 
 		TSharedPtr<ISourceObjectEnumerator> CurrentEnumerator;
 		TWeakObjectPtr<UObject> SourceObject;
 		TArray<TWeakObjectPtr<UObject>> TypesToParseForMembers;
 		TQueue<TWeakObjectPtr<UBlueprintNodeSpawner>> CurrentSpawners;
+		// Only set when the actions are built for the documented types only, instead of using the action database
+		TUniquePtr<FDocGenActionCollector> ActionCollector;
 
 		TUniquePtr<FNodeDocsGenerator> DocGen;
+
+		FString IntermediateDir;
+		// Fingerprints of this run, only valid for incremental builds
+		TSharedPtr<FDocGenManifest> Manifest;
+		// Fingerprints of the previous run, only valid if its intermediate docs can be reused
+		TSharedPtr<FDocGenManifest> PreviousManifest;
+		// Incremental builds, game thread only. Types are keyed on their doc directory, @see FDocGenManifest.
+		// Doc directory of the type of the source being enumerated, and whether it changed since the previous run
+		FString SourceDocDir;
+		bool bSourceChanged = true;
+		// Regenerated types, including the ones whose fingerprint didn't change but that a changed source adds nodes to
+		TSet<FString> InvalidatedTypeDirs;
+		// Sources whose type is up to date
+		TMap<FString, TWeakObjectPtr<UObject>> UpToDateSources;
+		// Up to date sources whose nodes weren't spawned
+		TSet<FString> SkippedSources;
+		// Up to date sources adding nodes to a regenerated class, their nodes must be spawned anyway
+		TSet<FString> SourcesToRevisit;
+		// Skipped sources to enumerate again once the enumerators are done
+		TArray<FName> LateSources;
+		TSet<TWeakObjectPtr<UObject>> RevisitedSources;
+
+		DocGenThreads::FGameThreadHandoffStats HandoffStats;
+		FDocGenStats Stats;
 	};
 
 	struct FDocGenOutputTask
@@ -0,0 +1,102 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "DocTreeNode.h"
+#include "Misc/ScopeRWLock.h"
+
+namespace
+{
+	// Most documents fit in a single block
+	const SIZE_T ArenaBlockSize = 16 * 1024;
+
+	// Keys are case sensitive, unlike the default FString keys of TSet
+	struct FInternedKeyFuncs : BaseKeyFuncs<TUniquePtr<FString>, FStringView>
+	{
+		static FStringView GetSetKey(const TUniquePtr<FString>& Element) { return *Element; }
+		static bool Matches(FStringView A, FStringView B) { return A.Equals(B, ESearchCase::CaseSensitive); }
+		static uint32 GetKeyHash(FStringView Key) { return FCrc::MemCrc32(Key.GetData(), Key.Len() * sizeof(TCHAR)); }
+	};
+
+	struct FInternedKeys
+	{
+		FRWLock Lock;
+		// Elements are never removed, the strings don't move when the set grows
+		TSet<TUniquePtr<FString>, FInternedKeyFuncs> Keys;
+	};
+
+	FInternedKeys& GetInternedKeys()
+	{
+		static FInternedKeys InternedKeys;
+		return InternedKeys;
+	}
+} // namespace
+
+FDocTreeArena::~FDocTreeArena()
+{
+	for (void* Block : Blocks)
+	{
+		FMemory::Free(Block);
+	}
+}
+
+void* FDocTreeArena::Allocate(SIZE_T Size, SIZE_T Alignment)
+{
+	uint8* Result = Align(Cursor, Alignment);
+	if (!Cursor || Result + Size > End)
+	{
+		// Large allocations get their own block so the current one can still be filled
+		if (Size + Alignment > ArenaBlockSize / 4)
+		{
+			return Blocks.Add_GetRef(FMemory::Malloc(Size, Alignment));
+		}
+
+		Cursor = static_cast<uint8*>(Blocks.Add_GetRef(FMemory::Malloc(ArenaBlockSize)));
+		End = Cursor + ArenaBlockSize;
+		Result = Align(Cursor, Alignment);
+	}
+
+	Cursor = Result + Size;
+	return Result;
+}
+
+const FString& FDocTreeKeys::Intern(FStringView Key)
+{
+	FInternedKeys& InternedKeys = GetInternedKeys();
+	{
+		FReadScopeLock ReadLock(InternedKeys.Lock);
+		if (const TUniquePtr<FString>* Found = InternedKeys.Keys.Find(Key))
+		{
+			return **Found;
+		}
+	}
+
+	FWriteScopeLock WriteLock(InternedKeys.Lock);
+	// May have been added since the read lock was released
+	if (const TUniquePtr<FString>* Found = InternedKeys.Keys.Find(Key))
+	{
+		return **Found;
+	}
+	const FSetElementId Id = InternedKeys.Keys.Add(MakeUnique<FString>(Key));
+	return *InternedKeys.Keys[Id];
+}
+
+void DocTreeNode::Object::Add(FDocTreeArena& Arena, const FString& Key, DocTreeNode* Value)
+{
+	if (NumChildren == MaxChildren)
+	{
+		// The previous array stays in the arena until the document is released
+		const int32 NewMax = FMath::Max(4, MaxChildren * 2);
+		FChild* NewChildren = static_cast<FChild*>(Arena.Allocate(NewMax * sizeof(FChild), alignof(FChild)));
+		for (int32 Index = 0; Index < NumChildren; ++Index)
+		{
+			new (&NewChildren[Index]) FChild(Children[Index]);
+		}
+		Children = NewChildren;
+		MaxChildren = NewMax;
+	}
+
+	new (&Children[NumChildren++]) FChild {Key, Value};
+}
@@ -1,120 +1,237 @@
 #pragma once
-#include "Containers/Map.h"
+#include "Containers/StringView.h"
 #include "Containers/UnrealString.h"
 #include "CoreMinimal.h"
 #include "Misc/Optional.h"
 #include "Templates/SharedPointer.h"
-#include "VariantWrapper.h"
+#include "Templates/UniquePtr.h"
 
-class DocTreeNode : public TSharedFromThis<DocTreeNode>
+// Memory of one document (a root node and all its descendants). Nothing allocated from it is destructed,
+// everything is released at once with the arena.
+class FDocTreeArena
 {
 public:
-	using Object = TMultiMap<FString, TSharedPtr<DocTreeNode>>;
+	FDocTreeArena() = default;
+	FDocTreeArena(const FDocTreeArena&) = delete;
+	FDocTreeArena& operator=(const FDocTreeArena&) = delete;
+	~FDocTreeArena();
+
+	void* Allocate(SIZE_T Size, SIZE_T Alignment);
+
+	template <typename T, typename... ArgTypes>
+	T* New(ArgTypes&&... Args)
+	{
+		return new (Allocate(sizeof(T), alignof(T))) T(Forward<ArgTypes>(Args)...);
+	}
 
 private:
-	struct NullValue
-	{};
+	TArray<void*, TInlineAllocator<4>> Blocks;
+	uint8* Cursor = nullptr;
+	uint8* End = nullptr;
+};
+
+// Keys of the doc tree nodes are interned for the whole run, so each node only holds a reference to its key.
+struct FDocTreeKeys
+{
+	// Thread safe. The returned string lives until the module is unloaded.
+	static const FString& Intern(FStringView Key);
+};
+
+// Nodes are allocated from the arena of their document, only the root is a regular shared object. Pointers to other
+// nodes share the ownership of the root, so a document is released at once when nothing references it anymore.
+class DocTreeNode : public TSharedFromThis<DocTreeNode>
+{
+public:
+	struct FChild
+	{
+		const FString& Key;
+		DocTreeNode* Value;
+	};
+
+	// Children of a node, in the order they were added. A key may appear several times.
+	class Object
+	{
+	public:
+		const FChild* begin() const { return Children; }
+		const FChild* end() const { return Children + NumChildren; }
+		int32 Num() const { return NumChildren; }
 
-	enum class InternalDataType
+		// First child with this key (case sensitive)
+		const DocTreeNode* Find(FStringView Key) const
+		{
+			for (const FChild& Child : *this)
+			{
+				if (Key.Equals(Child.Key, ESearchCase::CaseSensitive))
+				{
+					return Child.Value;
+				}
+			}
+			return nullptr;
+		}
+
+		bool Contains(FStringView Key) const { return Find(Key) != nullptr; }
+
+	private:
+		friend class DocTreeNode;
+		void Add(FDocTreeArena& Arena, const FString& Key, DocTreeNode* Value);
+
+		FChild* Children = nullptr;
+		int32 NumChildren = 0;
+		int32 MaxChildren = 0;
+	};
+
+private:
+	enum class InternalDataType : uint8
 	{
 		String,
 		Object,
 		Null
 	};
+
 	// Nodes are either an array, or an object, or a string value
-	DocGen::Variant<Object, FString, NullValue> Value;
+	Object Children;
+	const TCHAR* String = TEXT("");
+	int32 StringLen = 0;
 	InternalDataType CurrentDataType = InternalDataType::Null;
 	bool bValueRequiresEscaping = false;
 
-public:
-	void SetValue(const FString& NewValue, bool bEscapeValue = false)
+	// The root owns the arena of the whole document
+	DocTreeNode* Root;
+	TUniquePtr<FDocTreeArena> Arena;
+
+	struct FChildTag
+	{};
+
+	FDocTreeArena& GetArena()
 	{
-		if (CurrentDataType == InternalDataType::Null)
+		if (!Root->Arena)
 		{
-			Value.Set<FString>(FString());
-			CurrentDataType = InternalDataType::String;
+			Root->Arena = MakeUnique<FDocTreeArena>();
 		}
-		auto StringPtr = Value.TryGet<FString>();
-		check(StringPtr);
+		return *Root->Arena;
+	}
+
+	TSharedPtr<DocTreeNode> ToSharedPtr(const DocTreeNode* Node) const
+	{
+		// Shares the ownership of the root, which must be owned by a shared pointer
+		return TSharedPtr<DocTreeNode>(Root->AsShared(), const_cast<DocTreeNode*>(Node));
+	}
+
+public:
+	// Creates the root of a new document
+	DocTreeNode()
+		: Root(this)
+	{}
+
+	// Only used by AppendChild, for nodes allocated from the arena of InRoot
+	DocTreeNode(FChildTag, DocTreeNode& InRoot)
+		: Root(&InRoot)
+	{}
+
+	DocTreeNode(const DocTreeNode&) = delete;
+	DocTreeNode& operator=(const DocTreeNode&) = delete;
+
+	void SetValue(FStringView NewValue, bool bEscapeValue = false)
+	{
+		check(CurrentDataType != InternalDataType::Object);
+		CurrentDataType = InternalDataType::String;
 		bValueRequiresEscaping = bEscapeValue;
-		Value.Set<FString>(NewValue);
+
+		TCHAR* Buffer = static_cast<TCHAR*>(GetArena().Allocate((NewValue.Len() + 1) * sizeof(TCHAR), alignof(TCHAR)));
+		FMemory::Memcpy(Buffer, NewValue.GetData(), NewValue.Len() * sizeof(TCHAR));
+		Buffer[NewValue.Len()] = TEXT('\0');
+		String = Buffer;
+		StringLen = NewValue.Len();
 	}
 
-	const FString& GetValue()
+	// Empty if the node isn't a string value
+	FStringView GetValue() const
 	{
-		if (CurrentDataType == InternalDataType::Null)
-		{
-			Value.Set<FString>(FString());
-			CurrentDataType = InternalDataType::String;
-		}
-		auto StringPtr = Value.TryGet<FString>();
-		check(StringPtr);
-		return *StringPtr;
+		return FStringView(String, StringLen);
 	}
 
-	TSharedPtr<DocTreeNode> FindChildByName(const FString& ChildName) const
+	// Read-only access for serializers rendering the tree themselves, null if the node holds another kind of value
+	const Object* TryGetObject() const
 	{
-		const Object* ObjPtr = Value.TryGet<Object>();
-		check(ObjPtr);
-		const TSharedPtr<DocTreeNode>* FoundChild = ObjPtr->Find(ChildName);
-		if (FoundChild != nullptr)
-		{
-			return *FoundChild;
-		}
-		else
-		{
-			return TSharedPtr<DocTreeNode>();
-		}
+		return CurrentDataType == InternalDataType::Object ? &Children : nullptr;
+	}
+
+	TOptional<FStringView> TryGetString() const
+	{
+		return CurrentDataType == InternalDataType::String ? TOptional<FStringView>(GetValue()) : NullOpt;
+	}
+
+	TSharedPtr<DocTreeNode> FindChildByName(FStringView ChildName) const
+	{
+		check(CurrentDataType != InternalDataType::String);
+		const DocTreeNode* FoundChild = Children.Find(ChildName);
+		return FoundChild ? ToSharedPtr(FoundChild) : TSharedPtr<DocTreeNode>();
 	}
 
 	TSharedPtr<DocTreeNode> FindChildByPredicate(TFunction<bool(const TSharedPtr<DocTreeNode>&)> Predicate) const
 	{
-		const Object* ObjPtr = Value.TryGet<Object>();
-		check(ObjPtr);
-		for (const auto& Pair : *ObjPtr)
+		check(CurrentDataType != InternalDataType::String);
+		for (const FChild& Child : Children)
 		{
-			if (Predicate(Pair.Value))
-				return Pair.Value;
+			TSharedPtr<DocTreeNode> ChildPtr = ToSharedPtr(Child.Value);
+			if (Predicate(ChildPtr))
+				return ChildPtr;
 		}
 
 		return nullptr;
 	}
 
-	TSharedPtr<DocTreeNode> AppendChild(const FString& ChildName)
+	TSharedPtr<DocTreeNode> AppendChild(FStringView ChildName)
 	{
-		if (CurrentDataType == InternalDataType::Null)
-		{
-			Value.Set<Object>(Object());
-			CurrentDataType = InternalDataType::Object;
-		}
-		auto ObjPtr = Value.TryGet<Object>();
-		check(ObjPtr);
-		TSharedPtr<DocTreeNode> NewChild = MakeShared<DocTreeNode>();
-		ObjPtr->Add(ChildName, NewChild);
-		return NewChild;
+		check(CurrentDataType != InternalDataType::String);
+		CurrentDataType = InternalDataType::Object;
+		FDocTreeArena& DocArena = GetArena();
+		DocTreeNode* NewChild = DocArena.New<DocTreeNode>(FChildTag(), *Root);
+		Children.Add(DocArena, FDocTreeKeys::Intern(ChildName), NewChild);
+		return ToSharedPtr(NewChild);
 	}
 
-	TSharedPtr<DocTreeNode> AppendChildWithValue(const FString& ChildName, const FString& NewValue)
+	TSharedPtr<DocTreeNode> AppendChildWithValue(FStringView ChildName, FStringView NewValue)
 	{
 		TSharedPtr<DocTreeNode> NewChild = AppendChild(ChildName);
 		NewChild->SetValue(NewValue);
 		return NewChild;
 	}
 
-	TSharedPtr<DocTreeNode> AppendChildWithValueEscaped(const FString& ChildName, const FString& NewValue)
+	TSharedPtr<DocTreeNode> AppendChildWithValueEscaped(FStringView ChildName, FStringView NewValue)
 	{
 		TSharedPtr<DocTreeNode> NewChild = AppendChild(ChildName);
 		NewChild->SetValue(NewValue, true);
 		return NewChild;
 	}
 
+	// Appends copies of the children of Source, which may belong to another document
+	void AppendCopiesOfChildren(const DocTreeNode& Source)
+	{
+		for (const FChild& Child : Source.Children)
+		{
+			TSharedPtr<DocTreeNode> NewChild = AppendChild(Child.Key);
+			if (Child.Value->CurrentDataType == InternalDataType::String)
+			{
+				NewChild->SetValue(Child.Value->GetValue(), Child.Value->bValueRequiresEscaping);
+			}
+			else
+			{
+				NewChild->AppendCopiesOfChildren(*Child.Value);
+			}
+		}
+	}
+
 	struct IDocTreeSerializer
 	{
-		virtual FString EscapeString(const FString& InString) const = 0;
 		virtual FString GetFileExtension() const = 0;
 		virtual void SerializeObject(const Object& Object) = 0;
-		virtual void SerializeString(const FString& InString) = 0;
+		// bEscape is set for values which may contain characters reserved by the output format
+		virtual void SerializeString(FStringView InString, bool bEscape) = 0;
 		virtual void SerializeNull() = 0;
+		// Called before SerializeWith when the destination is known upfront, allowing serializers to stream to the file.
+		// SaveToFile is still called with the same destination once the tree has been serialized.
+		virtual void BeginFile(const FString& OutFileDirectory, const FString& OutFileName) {}
 		virtual bool SaveToFile(const FString& OutFileDirectory, const FString& OutFileName) = 0;
 		virtual ~IDocTreeSerializer() {};
 	};
@@ -127,17 +244,10 @@ public:
 				Serializer->SerializeNull();
 				break;
 			case InternalDataType::Object:
-				Serializer->SerializeObject(Value.Get<Object>());
+				Serializer->SerializeObject(Children);
 				break;
 			case InternalDataType::String:
-				if (bValueRequiresEscaping)
-				{
-					Serializer->SerializeString(Serializer->EscapeString(Value.Get<FString>()));
-				}
-				else
-				{
-					Serializer->SerializeString(Value.Get<FString>());
-				}
+				Serializer->SerializeString(GetValue(), bValueRequiresEscaping);
 		}
 	}
 };
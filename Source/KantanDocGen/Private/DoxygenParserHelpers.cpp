@@ -0,0 +1,118 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "DoxygenParserHelpers.h"
+#include "Misc/Char.h"
+#include "Misc/StringBuilder.h"
+
+namespace
+{
+	// Any '@' starts a tag, a '\' only when it starts a word (so paths and escapes are kept in the values)
+	bool IsTagStart(FStringView Comment, int32 Pos)
+	{
+		const TCHAR Char = Comment[Pos];
+		if (Char == TEXT('@'))
+		{
+			return true;
+		}
+		return Char == TEXT('\\') && (Pos == 0 || FChar::IsWhitespace(Comment[Pos - 1])) && Pos + 1 < Comment.Len() &&
+			   FChar::IsAlpha(Comment[Pos + 1]);
+	}
+
+	// Skips whitespace, and the '*' starting the lines of a block comment
+	void SkipWhitespace(FStringView Comment, int32& Pos, bool bAtLineStart)
+	{
+		for (; Pos < Comment.Len(); ++Pos)
+		{
+			const TCHAR Char = Comment[Pos];
+			if (FChar::IsLinebreak(Char))
+			{
+				bAtLineStart = true;
+			}
+			else if (!FChar::IsWhitespace(Char) && !(bAtLineStart && Char == TEXT('*')))
+			{
+				break;
+			}
+		}
+	}
+
+	// Without the trailing whitespace and the end of the comment
+	FStringView TrimValue(FStringView Value)
+	{
+		Value = Value.TrimEnd();
+		if (Value.EndsWith(TEXT('/')))
+		{
+			Value.RemoveSuffix(1);
+		}
+		if (Value.EndsWith(TEXT('*')))
+		{
+			Value.RemoveSuffix(1);
+		}
+		return Value.TrimEnd();
+	}
+} // namespace
+
+void Detail::ForEachDoxygenTag(FStringView Comment, TFunctionRef<void(FStringView Tag, FStringView Value)> Visitor)
+{
+	const int32 Len = Comment.Len();
+	// Only used by the values spanning several lines
+	TStringBuilder<512> JoinedLines;
+
+	int32 Pos = 0;
+	while (Pos < Len && !IsTagStart(Comment, Pos))
+	{
+		++Pos;
+	}
+
+	while (Pos < Len)
+	{
+		const int32 TagStart = ++Pos;
+		while (Pos < Len && !FChar::IsWhitespace(Comment[Pos]))
+		{
+			++Pos;
+		}
+		const FStringView Tag = Comment.Mid(TagStart, Pos - TagStart);
+
+		SkipWhitespace(Comment, Pos, false);
+		int32 LineStart = Pos;
+		bool bMultiLine = false;
+		while (Pos < Len && !IsTagStart(Comment, Pos))
+		{
+			if (!FChar::IsLinebreak(Comment[Pos]))
+			{
+				++Pos;
+				continue;
+			}
+
+			if (!bMultiLine)
+			{
+				JoinedLines.Reset();
+				bMultiLine = true;
+			}
+			JoinedLines << Comment.Mid(LineStart, Pos - LineStart).TrimEnd();
+
+			SkipWhitespace(Comment, Pos, true);
+			if (Pos < Len && !IsTagStart(Comment, Pos))
+			{
+				JoinedLines << TEXT(' ');
+			}
+			LineStart = Pos;
+		}
+
+		FStringView Value = Comment.Mid(LineStart, Pos - LineStart);
+		if (bMultiLine)
+		{
+			JoinedLines << Value;
+			Value = JoinedLines.ToView();
+		}
+
+		// e.g. "foo @ bar", which can't be a tag
+		if (!Tag.IsEmpty())
+		{
+			Visitor(Tag, TrimValue(Value));
+		}
+	}
+}
@@ -13,15 +13,18 @@ template < typename TChildEnum >
 class FCompositeEnumerator: public ISourceObjectEnumerator
 {
 public:
+	// ChildArgs are passed to the constructor of every child enumerator, after its name.
+	template < typename... TChildArgs >
 	FCompositeEnumerator(
-		TArray< FName > const& InNames
+		TArray< FName > const& InNames,
+		TChildArgs const&... ChildArgs
 	)
 	{
 		CurEnumIndex = 0;
 		TotalSize = 0;
 		Completed = 0;
 
-		Prepass(InNames);
+		Prepass(InNames, ChildArgs...);
 	}
 
 public:
@@ -63,11 +66,12 @@ public:
 	}
 
 protected:
-	void Prepass(TArray< FName > const& Names)
+	template < typename... TChildArgs >
+	void Prepass(TArray< FName > const& Names, TChildArgs const&... ChildArgs)
 	{
 		for(auto Name : Names)
 		{
-			auto Child = MakeUnique< TChildEnum >(Name);
+			auto Child = MakeUnique< TChildEnum >(Name, ChildArgs...);
 			TotalSize += Child->EstimatedSize();
 
 			ChildEnumList.Add(MoveTemp(Child));
@@ -6,6 +6,7 @@
 
 #include "ContentPathEnumerator.h"
 #include "KantanDocGenLog.h"
+#include "KantanDocGenTrace.h"
 #if UE_VERSION_OLDER_THAN(5, 3, 0)
 	#include "AssetRegistryModule.h"
 	#include "ARFilter.h"
@@ -15,19 +16,38 @@
 #endif
 #include "Engine/Blueprint.h"
 #include "Animation/AnimBlueprint.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/PackageName.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/SoftObjectPath.h"
 
 
+namespace
+{
+	// Time given to the async loader each time a blueprint is requested, so loads progress even when nothing else
+	// ticks it (e.g. in the commandlet)
+	const double PrefetchPumpTime = 0.002;
+}
+
 FContentPathEnumerator::FContentPathEnumerator(
-	FName const& InPath
+	FName const& InPath,
+	TArray< FName > const& InExcludedClasses,
+	int32 InPrefetchWindow,
+	std::atomic< uint64 >* InStallCycles
 )
 {
 	CurIndex = 0;
+	ExcludedClasses.Append(InExcludedClasses);
+	NextPrefetchIndex = 0;
+	PrefetchWindow = FMath::Max(0, InPrefetchWindow);
+	StallCycles = InStallCycles;
 
 	Prepass(InPath);
 }
 
 void FContentPathEnumerator::Prepass(FName const& Path)
 {
+	KANTANDOCGEN_TRACE_SCOPE(FContentPathEnumerator::Prepass);
 	auto& AssetRegistryModule = FModuleManager::GetModuleChecked< FAssetRegistryModule >("AssetRegistry");
 	auto& AssetRegistry = AssetRegistryModule.Get();
 
@@ -48,10 +68,109 @@ void FContentPathEnumerator::Prepass(FName const& Path)
 
 	AssetRegistry.GetAssetsByPath(Path, AssetList, true);
 	AssetRegistry.RunAssetsThroughFilter(AssetList, Filter);
+
+	const int32 NumMatchingAssets = AssetList.Num();
+	AssetList.RemoveAll([this](FAssetData const& AssetData) { return !IsDocumentable(AssetData); });
+	UE_LOG(LogKantanDocGen, Display, TEXT("Content path '%s': %d blueprints to document, %d skipped without loading."),
+		*Path.ToString(), AssetList.Num(), NumMatchingAssets - AssetList.Num());
+}
+
+bool FContentPathEnumerator::IsDocumentable(FAssetData const& AssetData)
+{
+	// Tags may be missing from assets saved by older engine versions, in which case the blueprint is kept
+	FString BlueprintType;
+	if(AssetData.GetTagValue(FBlueprintTags::BlueprintType, BlueprintType) && BlueprintType == TEXT("BPTYPE_LevelScript"))
+	{
+		return false;
+	}
+
+	// Data only blueprints don't add any function, variable or event to their parent class
+	FString IsDataOnly;
+	if(AssetData.GetTagValue(FBlueprintTags::IsDataOnly, IsDataOnly) && IsDataOnly.ToBool())
+	{
+		return false;
+	}
+
+	if(ExcludedClasses.Num() == 0)
+	{
+		return true;
+	}
+
+	if(ExcludedClasses.Contains(AssetData.AssetName))
+	{
+		return false;
+	}
+
+	for(FName Tag : { FBlueprintTags::GeneratedClassPath, FBlueprintTags::ParentClassPath, FBlueprintTags::NativeParentClassPath })
+	{
+		FString ClassPath;
+		if(AssetData.GetTagValue(Tag, ClassPath) && IsExcludedClass(FPackageName::ExportTextPathToObjectPath(ClassPath)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FContentPathEnumerator::IsExcludedClass(FString const& ClassPath)
+{
+	if(ClassPath.IsEmpty() || ClassPath == TEXT("None"))
+	{
+		return false;
+	}
+
+	if(bool const* bCachedExcluded = ExcludedClassCache.Find(ClassPath))
+	{
+		return *bCachedExcluded;
+	}
+	// Guards against cycles in broken hierarchies
+	ExcludedClassCache.Add(ClassPath, false);
+
+	// Blueprint classes can be excluded by the name of their blueprint (without the _C suffix) as well
+	FString ClassName = FPackageName::ObjectPathToObjectName(ClassPath);
+	bool bExcluded = ExcludedClasses.Contains(FName(*ClassName)) ||
+		(ClassName.RemoveFromEnd(TEXT("_C")) && ExcludedClasses.Contains(FName(*ClassName)));
+
+	if(!bExcluded)
+	{
+		if(UClass* Class = FindObject< UClass >(nullptr, *ClassPath))
+		{
+			UClass* SuperClass = Class->GetSuperClass();
+			bExcluded = SuperClass && IsExcludedClass(SuperClass->GetPathName());
+		}
+		else
+		{
+			// Class of a blueprint which isn't loaded, go up its hierarchy through the tags of the blueprint asset
+			FString BlueprintPath = ClassPath;
+			BlueprintPath.RemoveFromEnd(TEXT("_C"));
+
+			auto& AssetRegistry = FModuleManager::GetModuleChecked< FAssetRegistryModule >("AssetRegistry").Get();
+#if UE_VERSION_OLDER_THAN(5, 3, 0)
+			FAssetData const ParentAsset = AssetRegistry.GetAssetByObjectPath(FName(*BlueprintPath));
+#else
+			FAssetData const ParentAsset = AssetRegistry.GetAssetByObjectPath(FSoftObjectPath(BlueprintPath));
+#endif
+			FString ParentClassPath;
+			if(ParentAsset.IsValid() && ParentAsset.GetTagValue(FBlueprintTags::ParentClassPath, ParentClassPath))
+			{
+				bExcluded = IsExcludedClass(FPackageName::ExportTextPathToObjectPath(ParentClassPath));
+			}
+		}
+	}
+
+	ExcludedClassCache[ClassPath] = bExcluded;
+	return bExcluded;
 }
 
 UObject* FContentPathEnumerator::GetNext()
 {
+	KANTANDOCGEN_TRACE_SCOPE(FContentPathEnumerator::GetNext);
+	if(PrefetchWindow > 0)
+	{
+		return GetNextPrefetched();
+	}
+
 	UObject* Result = nullptr;
 
 	while(CurIndex < AssetList.Num())
@@ -74,6 +193,64 @@ UObject* FContentPathEnumerator::GetNext()
 	return Result;
 }
 
+void FContentPathEnumerator::FillPrefetchWindow()
+{
+	while(Prefetched.Num() < PrefetchWindow && NextPrefetchIndex < AssetList.Num())
+	{
+		auto const& AssetData = AssetList[NextPrefetchIndex];
+		auto& Entry = Prefetched.AddDefaulted_GetRef();
+		Entry.AssetIndex = NextPrefetchIndex++;
+#if UE_VERSION_OLDER_THAN(5, 3, 0)
+		Entry.Handle = StreamableManager.RequestAsyncLoad(FSoftObjectPath(AssetData.ObjectPath));
+#else
+		Entry.Handle = StreamableManager.RequestAsyncLoad(AssetData.GetSoftObjectPath());
+#endif
+	}
+}
+
+UObject* FContentPathEnumerator::GetNextPrefetched()
+{
+	while(true)
+	{
+		FillPrefetchWindow();
+		if(Prefetched.Num() == 0)
+		{
+			return nullptr;
+		}
+
+		// Lets the loads of the whole window progress, even when nothing else ticks the async loader
+		ProcessAsyncLoading(true, false, PrefetchPumpTime);
+
+		// Handed back in asset list order, so the output doesn't depend on load timings. Later loads stay in flight.
+		FPrefetchedAsset Entry = MoveTemp(Prefetched[0]);
+		Prefetched.RemoveAt(0);
+		++CurIndex;
+
+		if(Entry.Handle.IsValid() && !Entry.Handle->HasLoadCompleted())
+		{
+			KANTANDOCGEN_TRACE_SCOPE(FContentPathEnumerator::Stall);
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			Entry.Handle->WaitUntilComplete();
+			if(StallCycles)
+			{
+				StallCycles->fetch_add(FPlatformTime::Cycles64() - StartCycles, std::memory_order_relaxed);
+			}
+		}
+
+		// Already in memory unless the load failed, in which case this is a last synchronous attempt
+		auto const& AssetData = AssetList[Entry.AssetIndex];
+		if(auto Blueprint = Cast< UBlueprint >(AssetData.GetAsset()))
+		{
+#if UE_VERSION_OLDER_THAN(5, 3, 0)
+			UE_LOG(LogKantanDocGen, Log, TEXT("Enumerating object '%s' at '%s'"), *Blueprint->GetName(), *AssetData.ObjectPath.ToString());
+#else
+			UE_LOG(LogKantanDocGen, Log, TEXT("Enumerating object '%s' at '%s'"), *Blueprint->GetName(), *AssetData.GetSoftObjectPath().ToString());
+#endif
+			return Blueprint;
+		}
+	}
+}
+
 float FContentPathEnumerator::EstimateProgress() const
 {
 	return (float)CurIndex / (AssetList.Num() - 1);
@@ -14,13 +14,23 @@
 #else
 	#include "AssetRegistry/AssetData.h"
 #endif
+#include "Engine/StreamableManager.h"
+
+#include <atomic>
 
 
 class FContentPathEnumerator: public ISourceObjectEnumerator
 {
 public:
+	// Blueprints which can't produce docs, or deriving from one of InExcludedClasses, are skipped without being loaded.
+	// Up to InPrefetchWindow blueprints are loaded asynchronously ahead of the one being documented, 0 loads each
+	// of them synchronously when it is enumerated. Blueprints are handed back in asset list order either way, and the
+	// time spent waiting on a load is added to InStallCycles.
 	FContentPathEnumerator(
-		FName const& InPath
+		FName const& InPath,
+		TArray< FName > const& InExcludedClasses = {},
+		int32 InPrefetchWindow = 0,
+		std::atomic< uint64 >* InStallCycles = nullptr
 	);
 
 public:
@@ -30,10 +40,33 @@ public:
 
 protected:
 	void Prepass(FName const& Path);
+	// Decides from the asset registry tags only, the blueprint isn't loaded
+	bool IsDocumentable(FAssetData const& AssetData);
+	bool IsExcludedClass(FString const& ClassPath);
+	void FillPrefetchWindow();
+	UObject* GetNextPrefetched();
 
 protected:
+	struct FPrefetchedAsset
+	{
+		int32 AssetIndex = INDEX_NONE;
+		// Keeps the blueprint loaded until it is handed back, so a GC in between doesn't collect it
+		TSharedPtr< FStreamableHandle > Handle;
+	};
+
 	TArray< FAssetData > AssetList;
 	int32 CurIndex;
+
+	TSet< FName > ExcludedClasses;
+	// Class path to whether it is, or derives from, an excluded class
+	TMap< FString, bool > ExcludedClassCache;
+
+	// In flight loads, in asset list order
+	TArray< FPrefetchedAsset > Prefetched;
+	FStreamableManager StreamableManager;
+	int32 NextPrefetchIndex;
+	int32 PrefetchWindow;
+	std::atomic< uint64 >* StallCycles;
 };
 
 
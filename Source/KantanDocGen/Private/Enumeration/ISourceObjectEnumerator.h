@@ -7,6 +7,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
 
 
 class UObject;
@@ -19,6 +20,22 @@ public:
 	virtual int32 EstimatedSize() const = 0;
 
 	virtual ~ISourceObjectEnumerator() {}
+
+	// Next object not yet in Enumerated, which is shared by enumerators whose sources may overlap
+	// (e.g. a class given by name and the module declaring it). Adds the returned object to Enumerated.
+	UObject* GetNextUnique(TSet< TWeakObjectPtr< UObject > >& Enumerated)
+	{
+		while(auto Obj = GetNext())
+		{
+			bool bAlreadyEnumerated = false;
+			Enumerated.Add(TWeakObjectPtr< UObject >(Obj), &bAlreadyEnumerated);
+			if(!bAlreadyEnumerated)
+			{
+				return Obj;
+			}
+		}
+		return nullptr;
+	}
 };
 
 
@@ -6,104 +6,100 @@
 
 #include "NativeModuleEnumerator.h"
 #include "KantanDocGenLog.h"
+#include "KantanDocGenTrace.h"
+#include "HAL/PlatformTime.h"
 #include "UObject/Package.h"
 #include "UObject/UObjectHash.h"
 #include "UObject/UnrealType.h"
 #include "Misc/EngineVersionComparison.h"
 
-FNativeModuleEnumerator::FNativeModuleEnumerator(FName const& InModuleName)
+FNativeModuleEnumerator::FNativeModuleEnumerator(TArray<FName> const& InModuleNames)
 {
 	CurIndex = 0;
 
-	Prepass(InModuleName);
+	Prepass(InModuleNames);
 }
 
-void FNativeModuleEnumerator::Prepass(FName const& ModuleName)
+void FNativeModuleEnumerator::Prepass(TArray<FName> const& ModuleNames)
 {
+	KANTANDOCGEN_TRACE_SCOPE(FNativeModuleEnumerator::Prepass);
 	// For native package, all classes are already loaded so it's no problem to fully enumerate during prepass.
 	// That way we have more info for progress estimation.
+	const double StartTime = FPlatformTime::Seconds();
 
-	// Attempt to find the package
-	auto PkgName = TEXT("/Script/") + ModuleName.ToString();
-
-	auto Package = FindPackage(nullptr, *PkgName);
-	if (Package == nullptr)
-	{
-		// If it is not in memory, try to load it.
-		Package = LoadPackage(nullptr, *PkgName, LOAD_None);
-	}
-	if (Package == nullptr)
+	TArray<UPackage*> Packages;
+	Packages.Reserve(ModuleNames.Num());
+	for (FName const& ModuleName : ModuleNames)
 	{
-		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to find specified package '%s', skipping."), *PkgName);
-		return;
-	}
-
-	// Make sure it's fully loaded (probably unnecessary since only native packages here, but no harm)
-	Package->FullyLoad();
+		auto PkgName = TEXT("/Script/") + ModuleName.ToString();
 
-	// @TODO: Work out why the below enumeration is called twice for every class in the package (it's called on the
-	// exact same uclass instance)
-	TSet<UObject*> Processed;
-
-	// Functor to invoke on every object found in the package
-	TFunction<void(UObject*)> ObjectEnumFtr = [&](UObject* Obj) {
-		// The BP action database appears to be keyed either on native UClass objects, or, in the
-		// case of blueprints, on the Blueprint object itself, as opposed to the generated class.
+		auto Package = FindPackage(nullptr, *PkgName);
+		if (Package == nullptr)
+		{
+			// If it is not in memory, try to load it.
+			Package = LoadPackage(nullptr, *PkgName, LOAD_None);
+		}
+		if (Package == nullptr)
+		{
+			UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to find specified package '%s', skipping."), *PkgName);
+			continue;
+		}
 
-		UObject* ObjectToProcess = nullptr;
+		// Make sure it's fully loaded (probably unnecessary since only native packages here, but no harm)
+		Package->FullyLoad();
+		Packages.AddUnique(Package);
+	}
 
-		// Native class?
-		if (auto Class = Cast<UClass>(Obj))
+	// The BP action database appears to be keyed either on native UClass objects, or, in the
+	// case of blueprints, on the Blueprint object itself, as opposed to the generated class.
+	// Types are direct inners of their package, so nested objects (functions, ...) aren't visited. Each inner is visited
+	// once, so no set is needed to deduplicate them. Types keep the order of their package's inners, as before.
+	auto AddIfType = [this](UObject* Obj) {
+		if (UClass* Class = Cast<UClass>(Obj))
 		{
 			if (Class->HasAllClassFlags(CLASS_Native) && !Class->HasAnyFlags(RF_ClassDefaultObject))
 			{
-				ObjectToProcess = Class;
+				ObjectList.Add(Class);
 			}
 		}
-		if (auto Struct = Cast<UScriptStruct>(Obj))
+		else if (UScriptStruct* Struct = Cast<UScriptStruct>(Obj))
 		{
-			if (!Struct->HasAnyFlags(EObjectFlags::RF_ClassDefaultObject ))
+			if (!Struct->HasAnyFlags(RF_ClassDefaultObject))
 			{
-				ObjectToProcess = Struct;
-				UE_LOG(LogKantanDocGen, Log, TEXT("Found struct '%s' in package '%s'"), *Obj->GetName(), *PkgName);
+				ObjectList.Add(Struct);
 			}
 		}
-		if (auto FoundUenum = Cast<UEnum>(Obj))
+		else if (UEnum* Enum = Cast<UEnum>(Obj))
 		{
-			if (!FoundUenum->HasAnyFlags(EObjectFlags::RF_ArchetypeObject | EObjectFlags::RF_ClassDefaultObject))
+			if (!Enum->HasAnyFlags(RF_ArchetypeObject | RF_ClassDefaultObject))
 			{
-				ObjectToProcess = FoundUenum;
-				UE_LOG(LogKantanDocGen, Log, TEXT("Found enum '%s' in package '%s'"), *Obj->GetName(), *PkgName);
+				ObjectList.Add(Enum);
 			}
 		}
-		if (ObjectToProcess && !Processed.Contains(ObjectToProcess))
-		{
-			UE_LOG(LogKantanDocGen, Log, TEXT("Enumerating object '%s' in package '%s'"), *ObjectToProcess->GetName(),
-				   *PkgName);
-
-			// Store this class
-			ObjectList.Add(ObjectToProcess);
-
-			Processed.Add(ObjectToProcess);
-		}
 	};
 
-	// Enumerate all objects in the package
+	for (UPackage* Package : Packages)
+	{
 #if UE_VERSION_OLDER_THAN(5, 8, 0)
-	ForEachObjectWithOuter(Package, ObjectEnumFtr, true /* Include nested */);
+		ForEachObjectWithOuter(Package, AddIfType, false /* Include nested */);
 #else
-	ForEachObjectWithOuter(Package, ObjectEnumFtr, EGetObjectsFlags::IncludeNestedObjects);
+		ForEachObjectWithOuter(Package, AddIfType, EGetObjectsFlags::None);
 #endif
+	}
+
+	UE_LOG(LogKantanDocGen, Display, TEXT("Found %d native types in %d modules in %.2fms."), ObjectList.Num(),
+		   Packages.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
 }
 
 UObject* FNativeModuleEnumerator::GetNext()
 {
+	KANTANDOCGEN_TRACE_SCOPE(FNativeModuleEnumerator::GetNext);
 	return CurIndex < ObjectList.Num() ? ObjectList[CurIndex++].Get() : nullptr;
 }
 
 float FNativeModuleEnumerator::EstimateProgress() const
 {
-	return (float) CurIndex / (ObjectList.Num() - 1);
+	return ObjectList.Num() > 0 ? (float) CurIndex / ObjectList.Num() : 1.0f;
 }
 
 int32 FNativeModuleEnumerator::EstimatedSize() const
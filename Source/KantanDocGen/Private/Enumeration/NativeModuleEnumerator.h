@@ -12,8 +12,10 @@
 class FNativeModuleEnumerator: public ISourceObjectEnumerator
 {
 public:
+	// Classes, structs and enums of every module, in the order of InModuleNames, gathered from the objects of each
+	// module package.
 	FNativeModuleEnumerator(
-		FName const& InModuleName
+		TArray< FName > const& InModuleNames
 	);
 
 public:
@@ -22,7 +24,7 @@ public:
 	virtual int32 EstimatedSize() const override;
 
 protected:
-	void Prepass(FName const& ModuleName);
+	void Prepass(TArray< FName > const& ModuleNames);
 
 protected:
 	TArray< TWeakObjectPtr< UObject > > ObjectList;
@@ -0,0 +1,227 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "SpecificClassEnumerator.h"
+#include "KantanDocGenLog.h"
+#include "KantanDocGenTrace.h"
+#include "Misc/EngineVersionComparison.h"
+#if UE_VERSION_OLDER_THAN(5, 3, 0)
+	#include "AssetRegistryModule.h"
+	#include "ARFilter.h"
+#else
+	#include "AssetRegistry/AssetRegistryModule.h"
+	#include "AssetRegistry/ARFilter.h"
+#endif
+#include "Engine/Blueprint.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	template < typename T >
+	T* FindTypeByName(FString const& Name)
+	{
+#if UE_VERSION_OLDER_THAN(5, 1, 0)
+		return FindObject< T >(ANY_PACKAGE, *Name);
+#else
+		return FindFirstObject< T >(*Name, EFindFirstObjectOptions::NativeFirst);
+#endif
+	}
+}
+
+FSpecificClassEnumerator::FSpecificClassEnumerator(
+	TArray< FName > const& InNames,
+	bool bInIncludeDependencies
+)
+{
+	CurIndex = 0;
+
+	Prepass(InNames, bInIncludeDependencies);
+}
+
+void FSpecificClassEnumerator::Prepass(TArray< FName > const& Names, bool bIncludeDependencies)
+{
+	KANTANDOCGEN_TRACE_SCOPE(FSpecificClassEnumerator::Prepass);
+	for(auto const& Name : Names)
+	{
+		if(auto Object = ResolveName(Name))
+		{
+			AddObject(Object);
+		}
+		else
+		{
+			UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to find specified class '%s', skipping."), *Name.ToString());
+		}
+	}
+
+	const int32 NumNamed = ObjectList.Num();
+	if(bIncludeDependencies)
+	{
+		while(PendingDependencies.Num() > 0)
+		{
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+			UStruct* Struct = PendingDependencies.Pop(false);
+#else
+			UStruct* Struct = PendingDependencies.Pop(EAllowShrinking::No);
+#endif
+			for(TFieldIterator< FProperty > PropertyIt(Struct, EFieldIteratorFlags::ExcludeSuper); PropertyIt; ++PropertyIt)
+			{
+				AddPropertyDependencies(*PropertyIt);
+			}
+
+			// Parameters of the functions of the type
+			for(TFieldIterator< UFunction > FunctionIt(Struct, EFieldIteratorFlags::ExcludeSuper); FunctionIt; ++FunctionIt)
+			{
+				for(TFieldIterator< FProperty > ParamIt(*FunctionIt); ParamIt; ++ParamIt)
+				{
+					AddPropertyDependencies(*ParamIt);
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogKantanDocGen, Display, TEXT("Specific classes: %d types found, %d dependencies added."), NumNamed,
+		ObjectList.Num() - NumNamed);
+}
+
+UObject* FSpecificClassEnumerator::ResolveName(FName const& Name)
+{
+	const FString NameString = Name.ToString();
+
+	// Object path, e.g. /Game/Folder/MyBlueprint.MyBlueprint or /Script/Engine.Actor
+	if(NameString.StartsWith(TEXT("/")))
+	{
+		return FSoftObjectPath(NameString).TryLoad();
+	}
+
+	if(auto Class = FindTypeByName< UClass >(NameString))
+	{
+		return Class;
+	}
+	if(auto Struct = FindTypeByName< UScriptStruct >(NameString))
+	{
+		return Struct;
+	}
+	if(auto Enum = FindTypeByName< UEnum >(NameString))
+	{
+		return Enum;
+	}
+
+	// Blueprint, only its asset is loaded
+	auto& AssetRegistry = FModuleManager::GetModuleChecked< FAssetRegistryModule >("AssetRegistry").Get();
+
+	FARFilter Filter;
+	Filter.bRecursiveClasses = true;
+#if UE_VERSION_OLDER_THAN(5, 3, 0)
+	Filter.ClassNames.Add(UBlueprint::StaticClass()->GetFName());
+#else
+	Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+#endif
+
+	TArray< FAssetData > Blueprints;
+	AssetRegistry.GetAssets(Filter, Blueprints);
+	for(auto const& AssetData : Blueprints)
+	{
+		if(AssetData.AssetName == Name)
+		{
+			return AssetData.GetAsset();
+		}
+	}
+
+	return nullptr;
+}
+
+void FSpecificClassEnumerator::AddObject(UObject* Object)
+{
+	// The BP action database is keyed on the blueprint itself, as opposed to its generated class
+	if(auto Class = Cast< UClass >(Object))
+	{
+		if(auto Blueprint = Cast< UBlueprint >(Class->ClassGeneratedBy))
+		{
+			Object = Blueprint;
+		}
+	}
+
+	if(!Object || Added.Contains(Object))
+	{
+		return;
+	}
+	Added.Add(Object);
+
+	UStruct* MembersOwner = nullptr;
+	if(auto Blueprint = Cast< UBlueprint >(Object))
+	{
+		MembersOwner = Blueprint->GeneratedClass;
+	}
+	else if(auto Struct = Cast< UStruct >(Object))
+	{
+		MembersOwner = Struct;
+	}
+	else if(!Object->IsA< UEnum >())
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("'%s' is not a class, blueprint, struct or enum, skipping."), *Object->GetName());
+		return;
+	}
+
+	UE_LOG(LogKantanDocGen, Log, TEXT("Enumerating object '%s'"), *Object->GetName());
+	ObjectList.Add(Object);
+
+	if(MembersOwner)
+	{
+		PendingDependencies.Add(MembersOwner);
+	}
+}
+
+void FSpecificClassEnumerator::AddPropertyDependencies(FProperty* Property)
+{
+	if(auto StructProperty = CastField< FStructProperty >(Property))
+	{
+		AddObject(StructProperty->Struct);
+	}
+	else if(auto EnumProperty = CastField< FEnumProperty >(Property))
+	{
+		AddObject(EnumProperty->GetEnum());
+	}
+	else if(auto ByteProperty = CastField< FByteProperty >(Property))
+	{
+		AddObject(ByteProperty->Enum);
+	}
+	else if(auto ArrayProperty = CastField< FArrayProperty >(Property))
+	{
+		AddPropertyDependencies(ArrayProperty->Inner);
+	}
+	else if(auto SetProperty = CastField< FSetProperty >(Property))
+	{
+		AddPropertyDependencies(SetProperty->ElementProp);
+	}
+	else if(auto MapProperty = CastField< FMapProperty >(Property))
+	{
+		AddPropertyDependencies(MapProperty->KeyProp);
+		AddPropertyDependencies(MapProperty->ValueProp);
+	}
+}
+
+UObject* FSpecificClassEnumerator::GetNext()
+{
+	KANTANDOCGEN_TRACE_SCOPE(FSpecificClassEnumerator::GetNext);
+	while(CurIndex < ObjectList.Num())
+	{
+		if(auto Object = ObjectList[CurIndex++].Get())
+		{
+			return Object;
+		}
+	}
+	return nullptr;
+}
+
+float FSpecificClassEnumerator::EstimateProgress() const
+{
+	return ObjectList.Num() > 0 ? (float)CurIndex / ObjectList.Num() : 1.0f;
+}
+
+int32 FSpecificClassEnumerator::EstimatedSize() const
+{
+	return ObjectList.Num();
+}
@@ -0,0 +1,39 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#pragma once
+
+#include "ISourceObjectEnumerator.h"
+
+
+// Enumerates the classes, blueprints, structs and enums given by name (or object path) without sweeping their module
+// or content path. Optionally adds the structs and enums used by the members of the named types, recursively.
+class FSpecificClassEnumerator: public ISourceObjectEnumerator
+{
+public:
+	FSpecificClassEnumerator(
+		TArray< FName > const& InNames,
+		bool bInIncludeDependencies = false
+	);
+
+public:
+	virtual UObject* GetNext() override;
+	virtual float EstimateProgress() const override;
+	virtual int32 EstimatedSize() const override;
+
+protected:
+	void Prepass(TArray< FName > const& Names, bool bIncludeDependencies);
+	static UObject* ResolveName(FName const& Name);
+	void AddObject(UObject* Object);
+	void AddPropertyDependencies(FProperty* Property);
+
+protected:
+	TArray< TWeakObjectPtr< UObject > > ObjectList;
+	TSet< UObject* > Added;
+	// Types whose members still have to be searched for dependencies
+	TArray< UStruct* > PendingDependencies;
+	int32 CurIndex;
+};
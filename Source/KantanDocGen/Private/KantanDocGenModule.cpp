@@ -9,6 +9,7 @@
 #include "DocGenTaskProcessor.h"
 #include "KantanDocGenCommands.h"
 #include "KantanDocGenLog.h"
+#include "KantanDocGenTrace.h"
 #include "UI/SKantanDocGenWidget.h"
 #include "ISettingsModule.h"
 #include "ISettingsSection.h"
@@ -27,6 +28,10 @@ IMPLEMENT_MODULE(FKantanDocGenModule, KantanDocGen)
 
 DEFINE_LOG_CATEGORY(LogKantanDocGen);
 
+UE_TRACE_CHANNEL_DEFINE(KantanDocGenChannel)
+TRACE_DECLARE_INT_COUNTER(KantanDocGen_QueuedNodes, TEXT("KantanDocGen/QueuedNodes"));
+TRACE_DECLARE_MEMORY_COUNTER(KantanDocGen_BytesWritten, TEXT("KantanDocGen/BytesWritten"));
+
 void FKantanDocGenModule::StartupModule()
 {
 	{
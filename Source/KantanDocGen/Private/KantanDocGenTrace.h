@@ -0,0 +1,22 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#pragma once
+
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+// Enable with -trace=cpu,kantandocgen (add counters to see the counters below)
+UE_TRACE_CHANNEL_EXTERN(KantanDocGenChannel)
+
+#define KANTANDOCGEN_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, KantanDocGenChannel)
+#define KANTANDOCGEN_TRACE_SCOPE_TEXT(Text) TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(Text, KantanDocGenChannel)
+
+// Nodes handed to the workers whose docs haven't been generated yet
+TRACE_DECLARE_INT_COUNTER_EXTERN(KantanDocGen_QueuedNodes);
+// Bytes of intermediate docs written to disk by the streaming serializers
+TRACE_DECLARE_MEMORY_COUNTER_EXTERN(KantanDocGen_BytesWritten);
@@ -15,22 +15,26 @@
 #include "BlueprintFunctionNodeSpawner.h"
 #include "BlueprintNodeSpawner.h"
 #include "DocTreeNode.h"
-#include "DoxygenParserHelpers.h"
 #include "EdGraphSchema_K2.h"
 #include "Engine/TextureRenderTarget2D.h"
 #include "Framework/Application/SlateApplication.h"
+#include "HAL/FileManager.h"
 #include "HighResScreenshot.h"
 #include "K2Node_DynamicCast.h"
 #include "K2Node_Message.h"
 #include "KantanDocGenLog.h"
+#include "KantanDocGenTrace.h"
 #include "Kismet2/BlueprintEditorUtils.h"
 #include "Kismet2/KismetEditorUtilities.h"
 #include "Misc/EngineVersionComparison.h"
+#include "Misc/ScopeExit.h"
 #include "NodeFactory.h"
 #include "OutputFormats/DocGenOutputFormatFactoryBase.h"
+#include "Runtime/ImageWriteQueue/Public/ImageWriteQueue.h"
 #include "Runtime/ImageWriteQueue/Public/ImageWriteTask.h"
 #include "SGraphNode.h"
 #include "SGraphPanel.h"
+#include "Widgets/SCanvas.h"
 #include "Slate/WidgetRenderer.h"
 #include "Stats/StatsMisc.h"
 #include "TextureResource.h"
@@ -41,12 +45,17 @@
 #include "K2Node_VariableGet.h"
 #include "K2Node_VariableSet.h"
 #include "DocGenHelper.h"
+#include "DocGenFieldCache.h"
+#include "DocGenImageCache.h"
+#include "DocGenManifest.h"
+#include "DocGenRenderTargetPool.h"
 #include "DocFiles/ClassDocFile.h"
 #include "DocFiles/StructDocFile.h"
 #include "DocFiles/EnumDocFile.h"
 #include "DocFiles/IndexDocFile.h"
 
-FNodeDocsGenerator::FNodeDocsGenerator(const TArray<class UDocGenOutputFormatFactoryBase*>& OutputFormats, const TArray<FName>& CustomMetaKeys)
+FNodeDocsGenerator::FNodeDocsGenerator(const TArray<class UDocGenOutputFormatFactoryBase*>& OutputFormats, const TArray<FName>& CustomMetaKeys,
+									   bool bDeduplicateInheritedMembers)
 	: OutputFormats(OutputFormats)
 {
 	auto IndexDoc = CreateDocFile<FIndexDocFile>();
@@ -57,6 +66,9 @@ FNodeDocsGenerator::FNodeDocsGenerator(const TArray<class UDocGenOutputFormatFac
 	ClassDoc->SetCustomMetaKeys(CustomMetaKeys);
 	StructDoc->SetCustomMetaKeys(CustomMetaKeys);
 	EnumDoc->SetCustomMetaKeys(CustomMetaKeys);
+
+	ClassDoc->SetDeduplicateInheritedMembers(bDeduplicateInheritedMembers);
+	StructDoc->SetDeduplicateInheritedMembers(bDeduplicateInheritedMembers);
 }
 
 FNodeDocsGenerator::~FNodeDocsGenerator()
@@ -66,6 +78,7 @@ FNodeDocsGenerator::~FNodeDocsGenerator()
 
 bool FNodeDocsGenerator::GT_Init(FString const& InDocsTitle, FString const& InOutputDir, UClass* BlueprintContextClass)
 {
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::GT_Init);
 	DummyBP = CastChecked<UBlueprint>(FKismetEditorUtilities::CreateBlueprint(
 		BlueprintContextClass, ::GetTransientPackage(), NAME_None, EBlueprintType::BPTYPE_Normal,
 		UBlueprint::StaticClass(), UBlueprintGeneratedClass::StaticClass(), NAME_None));
@@ -86,6 +99,8 @@ bool FNodeDocsGenerator::GT_Init(FString const& InDocsTitle, FString const& InOu
 
 	DocsTitle = InDocsTitle;
 
+	ImageWriteQueue = &FModuleManager::LoadModuleChecked<IImageWriteQueueModule>("ImageWriteQueue").GetWriteQueue();
+
 	GetDocFile<FIndexDocFile>()->CreateDocTree(DocsTitle);
 
 	GetDocFile<FClassDocFile>()->Clear();
@@ -97,6 +112,7 @@ bool FNodeDocsGenerator::GT_Init(FString const& InDocsTitle, FString const& InOu
 UK2Node* FNodeDocsGenerator::GT_InitializeForSpawner(UBlueprintNodeSpawner* Spawner, UObject* SourceObject,
 													 FNodeProcessingState& OutState)
 {
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::GT_InitializeForSpawner);
 	if (!IsSpawnerDocumentable(Spawner, SourceObject->IsA<UBlueprint>()))
 	{
 		return nullptr;
@@ -122,20 +138,45 @@ UK2Node* FNodeDocsGenerator::GT_InitializeForSpawner(UBlueprintNodeSpawner* Spaw
 		return nullptr;
 	}
 
+	// The node docs from the previous run may still be valid
+	if (NodeFilter ? !NodeFilter(AssociatedClass, SourceObject) : UpToDateTypes.Contains(AssociatedClass))
+	{
+		return nullptr;
+	}
+
+	const TSharedPtr<FClassDocFile> ClassDocFile = GetDocFile<FClassDocFile>();
+	FScopeLock Lock(&ClassDocFile->GetDocTreeLock());
+
 	// Create the class doc tree if necessary.
-	TSharedPtr<DocTreeNode> ClassDocTree = GetDocFile<FClassDocFile>()->GetDocTree(AssociatedClass, /*bCreate = */true);
+	TSharedPtr<DocTreeNode> ClassDocTree = ClassDocFile->GetDocTree(AssociatedClass, /*bCreate = */true);
+	if (!ClassDocTree.IsValid())
+	{
+		// Streaming finalize: classes are only released once every source has been enumerated, this is a bug
+		UE_LOG(LogKantanDocGen, Error, TEXT("Docs of %s were already written, skipping node %s spawned by %s."),
+			   *AssociatedClass->GetName(), *K2NodeInst->GetName(), *SourceObject->GetName());
+		return nullptr;
+	}
 
 	const FString ClassID = FDocGenHelper::GetDocId(AssociatedClass);
 
 	OutState = FNodeProcessingState();
 	OutState.ClassDocsPath = OutputDir / TEXT("Classes") / ClassID;
 	OutState.ClassDocTree = ClassDocTree;
+	OutState.ClassId = FString(ClassDocTree->FindChildByName(TEXT("id"))->GetValue());
+	OutState.ClassName = FString(ClassDocTree->FindChildByName(TEXT("display_name"))->GetValue());
 
 	return K2NodeInst;
 }
 
 bool FNodeDocsGenerator::GT_Finalize(FString OutputPath)
 {
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::GT_Finalize);
+	const TSharedPtr<const DocTreeNode> IndexDocTree = GetDocFile<FIndexDocFile>()->GetDocTree(nullptr);
+	for (UDocGenOutputFormatFactoryBase* OutputFormat : OutputFormats)
+	{
+		OutputFormat->BeginFinalize(IndexDocTree);
+	}
+
 	for (const auto& DocFile : DocFiles)
 	{
 		if (!DocFile.Value.IsValid() || !DocFile.Value->SaveFile(OutputPath, OutputFormats))
@@ -149,11 +190,38 @@ bool FNodeDocsGenerator::GT_Finalize(FString OutputPath)
 		return false;
 	}
 
+	// Docs written while the nodes were processed
+	if (!WaitForDocWrites() || NumFailedNodeDocWrites > 0)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to write some node or type docs"));
+		return false;
+	}
+
 	return true;
 }
 
+bool FNodeDocsGenerator::WaitForDocWrites()
+{
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::WaitForDocWrites);
+	FScopeLock Lock(&PendingDocWritesLock);
+	PendingDocWrites.WaitAll();
+	return PendingDocWrites.GetNumFailed() == 0;
+}
+
 void FNodeDocsGenerator::CleanUp()
 {
+	if (RenderTargetPool.GetNumCreated() > 0)
+	{
+		UE_LOG(LogKantanDocGen, Display, TEXT("Node snapshots used %d render targets (%d reuses)."),
+			   RenderTargetPool.GetNumCreated(), RenderTargetPool.GetNumReused());
+	}
+	RenderTargetPool.Empty();
+	WidgetRenderer.Reset();
+	if (NumRenderFlushes > 0)
+	{
+		UE_LOG(LogKantanDocGen, Display, TEXT("Node snapshots needed %d render thread flushes."), NumRenderFlushes);
+	}
+
 	if (GraphPanel.IsValid())
 	{
 		GraphPanel.Reset();
@@ -171,109 +239,332 @@ void FNodeDocsGenerator::CleanUp()
 	}
 }
 
-bool FNodeDocsGenerator::GenerateNodeImage(UEdGraphNode* Node, FNodeProcessingState& State)
+namespace
 {
-	SCOPE_SECONDS_COUNTER(GenerateNodeImageTime);
-
-
-	bool bSuccess = false;
+	// Atlas rendering: max size of an atlas, and space left between nodes so their anti-aliased edges don't bleed
+	const int32 AtlasMaxWidth = 2048;
+	const int32 AtlasMaxHeight = 4096;
+	const int32 AtlasPadding = 2;
+}
 
+bool FNodeDocsGenerator::GT_PrepareNodeImage(UEdGraphNode* Node, FNodeProcessingState& State)
+{
 	AdjustNodeForSnapshot(Node);
 
 	if (!ShouldNodeGenerateImage(Node))
 	{
-		return true;
+		return false;
 	}
 
-	FIntRect Rect;
+	// The image is saved later on a worker thread, but its path is needed right away by the node docs
+	const FString NodeName = FDocGenHelper::GetDocId(Node);
+	State.RelImageBasePath = TEXT("./img");
+	State.ImageFilename = FString::Printf(TEXT("nd_img_%s.png"), *FDocGenHelper::GetNodeImgName(Node));
+	State.Image.SavePath =
+		State.ClassDocsPath / FDocGenHelper::GetNodeDirectory(Node) / NodeName / TEXT("img") / State.ImageFilename;
 
-	TUniquePtr<TImagePixelData<FColor>> PixelData;
+	if (ImageCache.IsValid())
+	{
+		State.Image.CacheKey = FDocGenImageCache::ComputeNodeKey(Node);
+		if (ImageCache->Contains(State.Image.CacheKey))
+		{
+			// The cached image is copied by GenerateNodeImage, nothing to render
+			return false;
+		}
+		ImageCache->RecordMiss();
+	}
 
-	auto RenderNodeResult = Async(EAsyncExecution::TaskGraphMainThread, [this, Node, &Rect, &PixelData] {
-		auto NodeWidget = FNodeFactory::CreateNodeWidget(Node);
-		NodeWidget->SetOwner(GraphPanel.ToSharedRef());
+	return true;
+}
 
-		// Force a layout pass up front so GetDesiredSize() reflects the widget's natural size,
-		// then use that exact size as the render canvas below.
-		NodeWidget->SlatePrepass(FSlateApplicationBase::Get().GetApplicationScale());
-		const FVector2D Desired = NodeWidget->GetDesiredSize();
-		const FVector2D DrawSize(FMath::Max(Desired.X, 1.0f), FMath::Max(Desired.Y, 1.0f));
+TSharedRef<SGraphNode> FNodeDocsGenerator::GT_CreateNodeWidget(UEdGraphNode* Node, FIntPoint& OutImageSize)
+{
+	auto NodeWidget = FNodeFactory::CreateNodeWidget(Node);
+	NodeWidget->SetOwner(GraphPanel.ToSharedRef());
+
+	// Force a layout pass up front so GetDesiredSize() reflects the widget's natural size,
+	// then use that exact size as the render canvas.
+	NodeWidget->SlatePrepass(FSlateApplicationBase::Get().GetApplicationScale());
+	const FVector2D Desired = NodeWidget->GetDesiredSize();
+	OutImageSize = FIntPoint(FMath::Max((int32) Desired.X, 1), FMath::Max((int32) Desired.Y, 1));
+	return NodeWidget.ToSharedRef();
+}
 
-		const bool bUseGammaCorrection = false;
-		FWidgetRenderer Renderer(true);
-		Renderer.SetIsPrepassNeeded(true);
+bool FNodeDocsGenerator::GT_DrawWidget(TSharedRef<SWidget> Widget, FIntPoint ImageSize, TArray<FColor>& OutPixels)
+{
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::GT_DrawWidget);
+	// Kept for the whole run, along with the pooled render targets, instead of being recreated for each node
+	if (!WidgetRenderer.IsValid())
+	{
+		// Pooled render targets aren't cleared when reused, the renderer clears them before drawing
+		WidgetRenderer = MakeUnique<FWidgetRenderer>(true, /*bInClearTarget=*/true);
+		WidgetRenderer->SetIsPrepassNeeded(true);
+	}
 
-		// Manually create the render target (bypassing FWidgetRenderer::CreateTargetFor) so we can set
-		// SRGB=true independently of the `true` passed to the FWidgetRenderer constructor above.
-		const EPixelFormat RequestedFormat = FSlateApplication::Get().GetRenderer()->GetSlateRecommendedColorFormat();
-		UTextureRenderTarget2D* RenderTarget = NewObject<UTextureRenderTarget2D>();
-		RenderTarget->Filter = TF_Default;
-		RenderTarget->ClearColor = FLinearColor::Transparent;
-		RenderTarget->SRGB = true;
-		RenderTarget->TargetGamma = 1;
-		RenderTarget->InitCustomFormat(FMath::FloorToInt32(DrawSize.X), FMath::FloorToInt32(DrawSize.Y), RequestedFormat, /*bForceLinearGamma=*/true);
-		RenderTarget->UpdateResourceImmediate(true);
+	const EPixelFormat RequestedFormat = FSlateApplication::Get().GetRenderer()->GetSlateRecommendedColorFormat();
+	UTextureRenderTarget2D* RenderTarget = RenderTargetPool.Acquire(ImageSize, RequestedFormat);
+	ON_SCOPE_EXIT
+	{
+		RenderTargetPool.Release(RenderTarget);
+	};
 
-		Renderer.DrawWidget(RenderTarget, NodeWidget.ToSharedRef(), DrawSize, 0.0f, false);
+	// The pooled target may be bigger than the image, the widget is drawn in its top left corner
+	WidgetRenderer->DrawWidget(RenderTarget, Widget, FVector2D(ImageSize), 0.0f, false);
 #if UE_VERSION_NEWER_THAN(5, 0, 0)
-		FlushRenderingCommands();
+	FlushRenderingCommands();
 #else 
-		FlushRenderingCommands(true);
+	FlushRenderingCommands(true);
 #endif
-		FTextureRenderTargetResource* RTResource = RenderTarget->GameThread_GetRenderTargetResource();
+	++NumRenderFlushes;
+	FTextureRenderTargetResource* RTResource = RenderTarget->GameThread_GetRenderTargetResource();
 
-		const int32 ImageWidth = (int32) DrawSize.X;
-		const int32 ImageHeight = (int32) DrawSize.Y;
+	const FIntRect Rect = FIntRect(FIntPoint::ZeroValue, ImageSize);
+	FReadSurfaceDataFlags ReadPixelFlags(RCM_UNorm);
+	ReadPixelFlags.SetLinearToGamma(true); // Seems to not do anything at all on rendered node
+
+	OutPixels.SetNumUninitialized(ImageSize.X * ImageSize.Y);
+	if (RTResource->ReadPixelsPtr(OutPixels.GetData(), ReadPixelFlags, Rect) == false)
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to read pixels for node image."));
+		return false;
+	}
 
-		Rect = FIntRect(0, 0, ImageWidth, ImageHeight);
-		FReadSurfaceDataFlags ReadPixelFlags(RCM_UNorm);
-		ReadPixelFlags.SetLinearToGamma(true); // Seems to not do anything at all on rendered node
+	return true;
+}
 
-		PixelData = MakeUnique<TImagePixelData<FColor>>(FIntPoint(ImageWidth, ImageHeight));
-		PixelData->Pixels.SetNumUninitialized(ImageWidth * ImageHeight);
+bool FNodeDocsGenerator::GT_RenderNodeImage(UEdGraphNode* Node, FNodeProcessingState& State)
+{
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::GT_RenderNodeImage);
+	DocGenThreads::FScopedCycleAccumulator CycleCounter(RenderNodeImageCycles);
 
-		if (RTResource->ReadPixelsPtr(PixelData->Pixels.GetData(), ReadPixelFlags, Rect) == false)
+	if (!GT_PrepareNodeImage(Node, State))
+	{
+		return true;
+	}
+
+	FIntPoint ImageSize;
+	TSharedRef<SGraphNode> NodeWidget = GT_CreateNodeWidget(Node, ImageSize);
+
+	TUniquePtr<TImagePixelData<FColor>> PixelData = MakeUnique<TImagePixelData<FColor>>(ImageSize);
+	if (!GT_DrawWidget(NodeWidget, ImageSize, PixelData->Pixels))
+	{
+		return false;
+	}
+
+	State.Image.PixelData = MoveTemp(PixelData);
+	return true;
+}
+
+void FNodeDocsGenerator::GT_RenderNodeImages(TArray<FSpawnedNode>& Batch, bool bUseAtlas)
+{
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::GT_RenderNodeImages);
+	if (!bUseAtlas)
+	{
+		for (int32 Index = Batch.Num() - 1; Index >= 0; --Index)
 		{
-			UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to read pixels for node image."));
-			return false;
+			if (!GT_RenderNodeImage(Batch[Index].Node, Batch[Index].State))
+			{
+				UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to generate node image!"))
+				Batch.RemoveAt(Index);
+			}
 		}
-		BeginReleaseResource(RTResource);
-		return true;
-	});
+		return;
+	}
+
+	DocGenThreads::FScopedCycleAccumulator CycleCounter(RenderNodeImageCycles);
+
+	TArray<FAtlasEntry> Entries;
+	for (int32 Index = 0; Index < Batch.Num(); ++Index)
+	{
+		FSpawnedNode& Spawned = Batch[Index];
+		if (!GT_PrepareNodeImage(Spawned.Node, Spawned.State))
+		{
+			continue;
+		}
+
+		FAtlasEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.BatchIndex = Index;
+		Entry.Widget = GT_CreateNodeWidget(Spawned.Node, Entry.Size);
+	}
+
+	// Shelf packing works best with the tallest nodes first
+	Entries.StableSort([](const FAtlasEntry& A, const FAtlasEntry& B) { return A.Size.Y > B.Size.Y; });
 
-	if (!RenderNodeResult.Get())
+	TArray<int32> Failed;
+	TArray<FAtlasEntry*> AtlasEntries;
+	FIntPoint Cursor = FIntPoint::ZeroValue;
+	int32 ShelfHeight = 0;
+	FIntPoint AtlasSize = FIntPoint::ZeroValue;
+
+	auto FlushAtlas = [&]() {
+		if (AtlasEntries.Num() > 0 && !GT_RenderAtlas(AtlasEntries, AtlasSize, Batch))
+		{
+			for (const FAtlasEntry* Entry : AtlasEntries)
+			{
+				Failed.Add(Entry->BatchIndex);
+			}
+		}
+		AtlasEntries.Reset();
+		Cursor = FIntPoint::ZeroValue;
+		ShelfHeight = 0;
+		AtlasSize = FIntPoint::ZeroValue;
+	};
+
+	for (FAtlasEntry& Entry : Entries)
+	{
+		// Too big to share an atlas, render it on its own
+		if (Entry.Size.X > AtlasMaxWidth || Entry.Size.Y > AtlasMaxHeight)
+		{
+			FNodeProcessingState& State = Batch[Entry.BatchIndex].State;
+			TUniquePtr<TImagePixelData<FColor>> PixelData = MakeUnique<TImagePixelData<FColor>>(Entry.Size);
+			if (GT_DrawWidget(Entry.Widget.ToSharedRef(), Entry.Size, PixelData->Pixels))
+			{
+				State.Image.PixelData = MoveTemp(PixelData);
+			}
+			else
+			{
+				Failed.Add(Entry.BatchIndex);
+			}
+			continue;
+		}
+
+		// Start a new shelf
+		if (Cursor.X + Entry.Size.X > AtlasMaxWidth)
+		{
+			Cursor = FIntPoint(0, Cursor.Y + ShelfHeight + AtlasPadding);
+			ShelfHeight = 0;
+		}
+
+		// Start a new atlas
+		if (Cursor.Y + Entry.Size.Y > AtlasMaxHeight)
+		{
+			FlushAtlas();
+		}
+
+		Entry.Position = Cursor;
+		AtlasEntries.Add(&Entry);
+
+		Cursor.X += Entry.Size.X + AtlasPadding;
+		ShelfHeight = FMath::Max(ShelfHeight, Entry.Size.Y);
+		AtlasSize.X = FMath::Max(AtlasSize.X, Entry.Position.X + Entry.Size.X);
+		AtlasSize.Y = FMath::Max(AtlasSize.Y, Entry.Position.Y + Entry.Size.Y);
+	}
+	FlushAtlas();
+
+	// Remove from the highest index, so the other indices stay valid
+	Failed.Sort(TGreater<int32>());
+	for (int32 Index : Failed)
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to generate node image!"))
+		Batch.RemoveAt(Index);
+	}
+}
+
+bool FNodeDocsGenerator::GT_RenderAtlas(TArrayView<FAtlasEntry*> Entries, FIntPoint AtlasSize, TArray<FSpawnedNode>& Batch)
+{
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::GT_RenderAtlas);
+	TSharedRef<SCanvas> Canvas = SNew(SCanvas);
+	for (const FAtlasEntry* Entry : Entries)
+	{
+		Canvas->AddSlot()
+			.Position(FVector2D(Entry->Position))
+			.Size(FVector2D(Entry->Size))
+			[
+				Entry->Widget.ToSharedRef()
+			];
+	}
+
+	TSharedRef<FNodeImage::FAtlasPixels> Atlas = MakeShared<FNodeImage::FAtlasPixels>();
+	Atlas->Size = AtlasSize;
+	if (!GT_DrawWidget(Canvas, AtlasSize, Atlas->Pixels))
 	{
 		return false;
 	}
 
-	State.RelImageBasePath = TEXT("./img");
+	// Cropping happens later, on the image write threads
+	for (const FAtlasEntry* Entry : Entries)
+	{
+		FNodeImage& Image = Batch[Entry->BatchIndex].State.Image;
+		Image.Atlas = Atlas;
+		Image.AtlasRect = FIntRect(Entry->Position, Entry->Position + Entry->Size);
+	}
 
-	FString NodeName = FDocGenHelper::GetDocId(Node);
-	FString ImageBasePath = State.ClassDocsPath / FDocGenHelper::GetNodeDirectory(Node) / NodeName / TEXT("img");
-	//FDocGenHelper::CreateImgDir(ImageBasePath);
+	return true;
+}
 
-	FString ImgFilename = FString::Printf(TEXT("nd_img_%s.png"), *FDocGenHelper::GetNodeImgName(Node));
-	FString ScreenshotSaveName = ImageBasePath / ImgFilename;
+TFuture<bool> FNodeDocsGenerator::GenerateNodeImage(FNodeImage&& Image)
+{
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::GenerateNodeImage);
+	const FString ImageSavePath = Image.SavePath;
+	const FString ImageCacheKey = Image.CacheKey;
+	FDocGenHelper::RecordWrittenFile(ImageSavePath);
 
-	TUniquePtr<FImageWriteTask> ImageTask = MakeUnique<FImageWriteTask>();
-	ImageTask->PixelData = MoveTemp(PixelData);
-	ImageTask->Filename = ScreenshotSaveName;
-	ImageTask->Format = EImageFormat::PNG;
-	ImageTask->CompressionQuality = (int32) EImageCompressionQuality::Default;
-	ImageTask->bOverwriteFile = true;
+	// Nothing has been rendered, the image is either in the cache or not needed (see GT_PrepareNodeImage)
+	if (!Image.PixelData.IsValid() && !Image.Atlas.IsValid())
+	{
+		if (ImageCache.IsValid() && !ImageCacheKey.IsEmpty())
+		{
+			return Async(EAsyncExecution::ThreadPool, [this, ImageSavePath, ImageCacheKey]() {
+				return ImageCache->CopyCachedImage(ImageCacheKey, ImageSavePath);
+			});
+		}
+		return MakeFulfilledPromise<bool>(true).GetFuture();
+	}
+
+	check(ImageWriteQueue);
 
-	if (ImageTask->RunTask())
+	TUniquePtr<FImageWriteTask> ImageTask = MakeUnique<FImageWriteTask>();
+	if (Image.Atlas.IsValid())
 	{
-		// Success!
-		bSuccess = true;
-		State.ImageFilename = ImgFilename;
+		// Crop the node out of the atlas right before encoding
+		const FIntRect Rect = Image.AtlasRect;
+		ImageTask->PixelData = MakeUnique<TImagePixelData<FColor>>(Rect.Size());
+		ImageTask->PixelPreProcessors.Add([Atlas = Image.Atlas, Rect](FImagePixelData* PixelData) {
+			TArray<FColor>& Pixels = static_cast<TImagePixelData<FColor>*>(PixelData)->Pixels;
+			const int32 Width = Rect.Width();
+			Pixels.SetNumUninitialized(Width * Rect.Height());
+			for (int32 Y = 0; Y < Rect.Height(); ++Y)
+			{
+				const int32 AtlasOffset = (Rect.Min.Y + Y) * Atlas->Size.X + Rect.Min.X;
+				FMemory::Memcpy(&Pixels[Y * Width], &Atlas->Pixels[AtlasOffset], Width * sizeof(FColor));
+			}
+		});
 	}
 	else
 	{
-		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to save screenshot image for node: %s"), *NodeName);
+		ImageTask->PixelData = MoveTemp(Image.PixelData);
 	}
+	ImageTask->Filename = ImageSavePath;
+	ImageTask->Format = EImageFormat::PNG;
+	ImageTask->CompressionQuality = (int32) EImageCompressionQuality::Default;
+	ImageTask->bOverwriteFile = true;
 
-	return bSuccess;
+	const uint64 QueuedCycles = FPlatformTime::Cycles64();
+	return ImageWriteQueue->Enqueue(MoveTemp(ImageTask)).Next([this, ImageSavePath, ImageCacheKey, QueuedCycles](bool bSuccess) {
+		WriteNodeImageCycles.fetch_add(FPlatformTime::Cycles64() - QueuedCycles, std::memory_order_relaxed);
+		if (!bSuccess)
+		{
+			UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to save screenshot image: %s"), *ImageSavePath);
+		}
+		else if (ImageCache.IsValid() && !ImageCacheKey.IsEmpty())
+		{
+			ImageCache->StoreImage(ImageCacheKey, ImageSavePath);
+		}
+		return bSuccess;
+	});
+}
+
+void FNodeDocsGenerator::EnableImageCache(const FString& CacheDir)
+{
+	ImageCache = MakeUnique<FDocGenImageCache>(CacheDir);
+}
+
+void FNodeDocsGenerator::WaitForImageWrites()
+{
+	if (ImageWriteQueue)
+	{
+		ImageWriteQueue->CreateFence().Wait();
+	}
 }
 
 // @see SaveVariableDocFile for the reason why we don't use FDocFile here.
@@ -292,10 +583,49 @@ TSharedPtr<DocTreeNode> FNodeDocsGenerator::GetVariableDocTree(const FString& Va
 	return NewDocTree;
 }
 
-bool FNodeDocsGenerator::UpdateClassDocWithNode(TSharedPtr<DocTreeNode> DocTree, UEdGraphNode* Node)
+void FNodeDocsGenerator::AppendVariableImagePaths(const FString& VariableId, DocTreeNode& VarDocTree) const
+{
+	if (const FVariableImagePaths* ImagePaths = VariableImagePathMap.Find(VariableId))
+	{
+		if (!ImagePaths->Getter.IsEmpty())
+			VarDocTree.AppendChildWithValueEscaped(TEXT("imgpath_get"), ImagePaths->Getter);
+		if (!ImagePaths->Setter.IsEmpty())
+			VarDocTree.AppendChildWithValueEscaped(TEXT("imgpath_set"), ImagePaths->Setter);
+	}
+}
+
+void FNodeDocsGenerator::GT_ReserveClassDocEntries(TArray<FSpawnedNode>& Batch)
+{
+	FScopeLock Lock(&GetDocFile<FClassDocFile>()->GetDocTreeLock());
+	for (FSpawnedNode& Spawned : Batch)
+	{
+		FNodeProcessingState& State = Spawned.State;
+		if (Spawned.Node->IsA<UK2Node_Event>())
+		{
+			continue;
+		}
+
+		if (Spawned.Node->IsA<UK2Node_Variable>())
+		{
+			bool bAlreadyReserved = false;
+			VariablesWithClassDocEntry.Add(State.ClassId / FDocGenHelper::GetDocId(Spawned.Node), &bAlreadyReserved);
+			if (!bAlreadyReserved)
+			{
+				State.ClassDocEntry = FDocGenHelper::GetChildNode(State.ClassDocTree, TEXT("variables"), /*bCreate = */true)
+										  ->AppendChild(TEXT("variable"));
+			}
+		}
+		else
+		{
+			State.ClassDocEntry =
+				FDocGenHelper::GetChildNode(State.ClassDocTree, TEXT("nodes"), /*bCreate = */true)->AppendChild(TEXT("node"));
+		}
+	}
+}
+
+bool FNodeDocsGenerator::UpdateClassDocWithNode(TSharedPtr<DocTreeNode> ClassDocEntry, UEdGraphNode* Node)
 {
-	auto DocTreeNodesElement = FDocGenHelper::GetChildNode(DocTree, TEXT("nodes"), /*bCreate = */true);
-	auto DocTreeNode = DocTreeNodesElement->AppendChild("node");
+	auto DocTreeNode = ClassDocEntry;
 	DocTreeNode->AppendChildWithValueEscaped(TEXT("id"), FDocGenHelper::GetDocId(Node));
 	DocTreeNode->AppendChildWithValueEscaped(TEXT("fulltitle"), FDocGenHelper::GetNodeFullTitle(Node));
 	DocTreeNode->AppendChildWithValueEscaped(TEXT("shorttitle"), FDocGenHelper::GetNodeShortTitle(Node));
@@ -306,11 +636,10 @@ bool FNodeDocsGenerator::UpdateClassDocWithNode(TSharedPtr<DocTreeNode> DocTree,
 }
 
 // @see SaveVariableDocFile for the reason why we don't use FDocFile here.
-bool FNodeDocsGenerator::UpdateClassDocWithVariable(TSharedPtr<DocTreeNode> DocTree, UK2Node_Variable* Node)
+bool FNodeDocsGenerator::UpdateClassDocWithVariable(TSharedPtr<DocTreeNode> ClassDocEntry, UK2Node_Variable* Node)
 {
 	FProperty* Property = Node->GetPropertyForVariable();
-	auto DocTreeNodesElement = FDocGenHelper::GetChildNode(DocTree, TEXT("variables"), /*bCreate = */true);
-	auto DocTreeNode = DocTreeNodesElement->AppendChild("variable");
+	auto DocTreeNode = ClassDocEntry;
 	DocTreeNode->AppendChildWithValueEscaped(TEXT("id"), FDocGenHelper::GetDocId(Node));
 	DocTreeNode->AppendChildWithValueEscaped(TEXT("display_name"), FDocGenHelper::GetDisplayName(Property));
 	DocTreeNode->AppendChildWithValueEscaped(TEXT("description"), FDocGenHelper::GetDescription(Property));
@@ -322,33 +651,34 @@ bool FNodeDocsGenerator::UpdateClassDocWithVariable(TSharedPtr<DocTreeNode> DocT
 
 bool FNodeDocsGenerator::GenerateNodeDocTree(UK2Node* Node, FNodeProcessingState& State)
 {
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::GenerateNodeDocTree);
 	if (auto EventNode = Cast<UK2Node_Event>(Node))
 	{
 		return true; // Skip events
 	}
-	SCOPE_SECONDS_COUNTER(GenerateNodeDocsTime);
+	DocGenThreads::FScopedCycleAccumulator CycleCounter(GenerateNodeDocsCycles);
 
 	TSharedPtr<DocTreeNode> NodeDocFile = MakeShared<DocTreeNode>();
 	NodeDocFile->AppendChildWithValueEscaped(TEXT("doctype"), TEXT("node"));
-	NodeDocFile->AppendChildWithValueEscaped("docs_name", DocsTitle);
-	NodeDocFile->AppendChildWithValueEscaped("class_id", State.ClassDocTree->FindChildByName("id")->GetValue());
-	NodeDocFile->AppendChildWithValueEscaped("class_name", State.ClassDocTree->FindChildByName("display_name")->GetValue());
-	NodeDocFile->AppendChildWithValueEscaped("shorttitle", FDocGenHelper::GetNodeShortTitle(Node));
+	NodeDocFile->AppendChildWithValueEscaped(TEXT("docs_name"), DocsTitle);
+	NodeDocFile->AppendChildWithValueEscaped(TEXT("class_id"), State.ClassId);
+	NodeDocFile->AppendChildWithValueEscaped(TEXT("class_name"), State.ClassName);
+	NodeDocFile->AppendChildWithValueEscaped(TEXT("shorttitle"), FDocGenHelper::GetNodeShortTitle(Node));
 	FString NodeFullTitle = FDocGenHelper::GetNodeFullTitle(Node);
-	NodeDocFile->AppendChildWithValueEscaped("fulltitle", NodeFullTitle);
-	NodeDocFile->AppendChildWithValueEscaped("description", FDocGenHelper::GetNodeDescription(Node));
-	NodeDocFile->AppendChildWithValueEscaped("imgpath", State.RelImageBasePath / State.ImageFilename);
-	NodeDocFile->AppendChildWithValueEscaped("category", FDocGenHelper::GetCategory(Node));
+	NodeDocFile->AppendChildWithValueEscaped(TEXT("fulltitle"), NodeFullTitle);
+	NodeDocFile->AppendChildWithValueEscaped(TEXT("description"), FDocGenHelper::GetNodeDescription(Node));
+	NodeDocFile->AppendChildWithValueEscaped(TEXT("imgpath"), State.RelImageBasePath / State.ImageFilename);
+	NodeDocFile->AppendChildWithValueEscaped(TEXT("category"), FDocGenHelper::GetCategory(Node));
 
 	if (auto FuncNode = Cast<UK2Node_CallFunction>(Node))
 	{
 		auto Func = FuncNode->GetTargetFunction();
 		if (Func)
 		{
-			NodeDocFile->AppendChildWithValueEscaped("funcname", Func->GetAuthoredName());
-			NodeDocFile->AppendChildWithValueEscaped("rawcomment", Func->GetMetaData(TEXT("Comment")));
-			NodeDocFile->AppendChildWithValue("static", FDocGenHelper::GetBoolString(Func->HasAnyFunctionFlags(FUNC_Static)));
-			NodeDocFile->AppendChildWithValue("autocast", FDocGenHelper::GetBoolString(Func->HasMetaData(TEXT("BlueprintAutocast"))));
+			NodeDocFile->AppendChildWithValueEscaped(TEXT("funcname"), Func->GetAuthoredName());
+			NodeDocFile->AppendChildWithValueEscaped(TEXT("rawcomment"), Func->GetMetaData(TEXT("Comment")));
+			NodeDocFile->AppendChildWithValue(TEXT("static"), FDocGenHelper::GetBoolString(Func->HasAnyFunctionFlags(FUNC_Static)));
+			NodeDocFile->AppendChildWithValue(TEXT("autocast"), FDocGenHelper::GetBoolString(Func->HasMetaData(TEXT("BlueprintAutocast"))));
 			TArray<FStringFormatArg> Args;
 
 			if (FProperty* RetProp = Func->GetReturnProperty())
@@ -383,7 +713,7 @@ bool FNodeDocsGenerator::GenerateNodeDocTree(UK2Node* Node, FNodeProcessingState
 			}
 			Args.Add({FuncParams});
 			Args.Add({Func->HasAnyFunctionFlags(FUNC_Const) ? " const" : ""});
-			NodeDocFile->AppendChildWithValueEscaped("rawsignature", FString::Format(TEXT("{0} {1}({2}){3}"), Args));
+			NodeDocFile->AppendChildWithValueEscaped(TEXT("rawsignature"), FString::Format(TEXT("{0} {1}({2}){3}"), Args));
 
 			FDocGenHelper::GenerateDoxygenNode(Func, NodeDocFile);
 		}
@@ -417,9 +747,21 @@ bool FNodeDocsGenerator::GenerateNodeDocTree(UK2Node* Node, FNodeProcessingState
 
 	const FString NodeDocID = FDocGenHelper::GetDocId(Node);
 	const FString NodeDocsPath = State.ClassDocsPath / TEXT("Nodes") / NodeDocID;
-	FDocGenHelper::SerializeDocToFile(NodeDocFile, NodeDocsPath, NodeDocID, OutputFormats);
+	// Written right away (rather than through SerializeDocToFileAsync), so the node stage only completes once the doc is
+	// on disk and bounds the pending writes too
+	if (!FDocGenHelper::SerializeDocToFile(NodeDocFile, NodeDocsPath, NodeDocID, OutputFormats))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to write the doc of node %s"), *NodeDocID);
+		++NumFailedNodeDocWrites;
+	}
+
+	if (!State.ClassDocEntry.IsValid())
+	{
+		return true;
+	}
 
-	if (!UpdateClassDocWithNode(State.ClassDocTree, Node))
+	FScopeLock Lock(&GetDocFile<FClassDocFile>()->GetDocTreeLock());
+	if (!UpdateClassDocWithNode(State.ClassDocEntry, Node))
 	{
 		return false;
 	}
@@ -429,10 +771,14 @@ bool FNodeDocsGenerator::GenerateNodeDocTree(UK2Node* Node, FNodeProcessingState
 
 bool FNodeDocsGenerator::GenerateVariableDocTree(UK2Node_Variable* Node, FNodeProcessingState& State)
 {
-	SCOPE_SECONDS_COUNTER(GenerateNodeDocsTime);
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::GenerateVariableDocTree);
+	DocGenThreads::FScopedCycleAccumulator CycleCounter(GenerateNodeDocsCycles);
 
 	FString VariableId = FDocGenHelper::GetDocId(Node);
-	FString ClassId = State.ClassDocTree->FindChildByName("id")->GetValue();
+	const FString& ClassId = State.ClassId;
+
+	// Getter and setter nodes of the same variable share a doc tree and may be processed concurrently
+	FScopeLock VariableLock(&VariableDocTreeLock);
 
 	bool VariableExists = false;
 	TSharedPtr<DocTreeNode> VarDocFile = GetVariableDocTree(ClassId / VariableId, VariableExists, /*bCreate = */true);
@@ -441,46 +787,51 @@ bool FNodeDocsGenerator::GenerateVariableDocTree(UK2Node_Variable* Node, FNodePr
 
 	if (!State.ImageFilename.IsEmpty())
 	{
+		FVariableImagePaths& ImagePaths = VariableImagePathMap.FindOrAdd(ClassId / VariableId);
 		if (Node->IsA<UK2Node_VariableGet>())
-			VarDocFile->AppendChildWithValueEscaped("imgpath_get", State.RelImageBasePath / State.ImageFilename);
+			ImagePaths.Getter = State.RelImageBasePath / State.ImageFilename;
 		else if (Node->IsA<UK2Node_VariableSet>())
-			VarDocFile->AppendChildWithValueEscaped("imgpath_set", State.RelImageBasePath / State.ImageFilename);
+			ImagePaths.Setter = State.RelImageBasePath / State.ImageFilename;
 	}
 
 	// @TODO: Once the FDocFile is used, the init below should be done during the GetVariableDocTree above when creating the file.
 	// So this condition should be removed too.
-	if (VariableExists)
+	if (!VariableExists)
+	{
+		//UE_LOG(LogKantanDocGen, Error, TEXT("New variable %s, node: %s"), *(ClassId / VariableId), *NodeName);
+		// @TODO: Once the FDocFile is used, this should be moved in InitDocTree function.
+		FProperty* Property = Node->GetPropertyForVariable();
+		VarDocFile->AppendChildWithValueEscaped(TEXT("doctype"), TEXT("variable"));
+		VarDocFile->AppendChildWithValueEscaped(TEXT("docs_name"), DocsTitle);
+		VarDocFile->AppendChildWithValueEscaped(TEXT("class_id"), State.ClassId);
+		VarDocFile->AppendChildWithValueEscaped(TEXT("class_name"), State.ClassName);
+		VarDocFile->AppendChildWithValueEscaped(TEXT("id"), Property->GetAuthoredName());
+		VarDocFile->AppendChildWithValueEscaped(TEXT("display_name"), FDocGenHelper::GetDisplayName(Property));
+		VarDocFile->AppendChildWithValueEscaped(TEXT("description"), FDocGenHelper::GetDescription(Property));
+		VarDocFile->AppendChildWithValueEscaped(TEXT("category"), FDocGenHelper::GetCategory(Property));
+
+		UEdGraphPin* ValuePin = Node->GetValuePin();
+		VarDocFile->AppendChildWithValueEscaped(TEXT("variable_type"), FDocGenFieldCache::Get().GetPinTypeText(ValuePin->PinType));
+
+		bool bBlueprintRead, bBlueprintWrite;
+		FString BlueprintAccess = FDocGenHelper::GetPropertyBlueprintAccess(Property, bBlueprintRead, bBlueprintWrite);
+		if (!BlueprintAccess.IsEmpty())
+			VarDocFile->AppendChildWithValueEscaped(TEXT("blueprint_access"), BlueprintAccess);
+
+		bool bEditable, bEditableInTemplate, bEditableInInstance;
+		FString EditorAccess = FDocGenHelper::GetPropertyEditorAccess(Property, bEditable, bEditableInTemplate, bEditableInInstance);
+		if (!EditorAccess.IsEmpty())
+			VarDocFile->AppendChildWithValueEscaped(TEXT("editor_access"), EditorAccess);
+	}
+
+	// Only one of the getter and setter holds the entry of the variable in the class doc
+	if (!State.ClassDocEntry.IsValid())
 	{
-		//UE_LOG(LogKantanDocGen, Error, TEXT("Already existing variable %s, node: %s"), *(ClassId / VariableId), *NodeName);
 		return true;
 	}
 
-	//UE_LOG(LogKantanDocGen, Error, TEXT("New variable %s, node: %s"), *(ClassId / VariableId), *NodeName);
-	// @TODO: Once the FDocFile is used, this should be moved in InitDocTree function.
-	FProperty* Property = Node->GetPropertyForVariable();
-	VarDocFile->AppendChildWithValueEscaped(TEXT("doctype"), TEXT("variable"));
-	VarDocFile->AppendChildWithValueEscaped(TEXT("docs_name"), DocsTitle);
-	VarDocFile->AppendChildWithValueEscaped(TEXT("class_id"), State.ClassDocTree->FindChildByName("id")->GetValue());
-	VarDocFile->AppendChildWithValueEscaped(TEXT("class_name"), State.ClassDocTree->FindChildByName("display_name")->GetValue());
-	VarDocFile->AppendChildWithValueEscaped(TEXT("id"), Property->GetAuthoredName());
-	VarDocFile->AppendChildWithValueEscaped(TEXT("display_name"), FDocGenHelper::GetDisplayName(Property));
-	VarDocFile->AppendChildWithValueEscaped(TEXT("description"), FDocGenHelper::GetDescription(Property));
-	VarDocFile->AppendChildWithValueEscaped(TEXT("category"), FDocGenHelper::GetCategory(Property));
-
-	UEdGraphPin* ValuePin = Node->GetValuePin();
-	VarDocFile->AppendChildWithValueEscaped(TEXT("variable_type"), UEdGraphSchema_K2::TypeToText(ValuePin->PinType).ToString());
-	
-	bool bBlueprintRead, bBlueprintWrite;
-	FString BlueprintAccess = FDocGenHelper::GetPropertyBlueprintAccess(Property, bBlueprintRead, bBlueprintWrite);
-	if (!BlueprintAccess.IsEmpty())
-		VarDocFile->AppendChildWithValueEscaped(TEXT("blueprint_access"), BlueprintAccess);
-
-	bool bEditable, bEditableInTemplate, bEditableInInstance;
-	FString EditorAccess = FDocGenHelper::GetPropertyEditorAccess(Property, bEditable, bEditableInTemplate, bEditableInInstance);
-	if (!EditorAccess.IsEmpty())
-		VarDocFile->AppendChildWithValueEscaped(TEXT("editor_access"), EditorAccess);
-
-	if (!UpdateClassDocWithVariable(State.ClassDocTree, Node))
+	FScopeLock ClassLock(&GetDocFile<FClassDocFile>()->GetDocTreeLock());
+	if (!UpdateClassDocWithVariable(State.ClassDocEntry, Node))
 	{
 		return false;
 	}
@@ -490,25 +841,112 @@ bool FNodeDocsGenerator::GenerateVariableDocTree(UK2Node_Variable* Node, FNodePr
 
 bool FNodeDocsGenerator::GenerateTypeMembers(UObject* Type)
 {
-	if (Type)
+	return CommitTypeMembers(Type, PrepareTypeMembers(Type));
+}
+
+TSharedPtr<DocTreeNode> FNodeDocsGenerator::PrepareTypeMembers(UObject* Type)
+{
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::PrepareTypeMembers);
+	// Up to date types are only added to the index, when committed
+	if (Type == nullptr || UpToDateTypes.Contains(FDocGenManifest::GetDocumentedType(Type)))
+	{
+		return nullptr;
+	}
+
+	UE_LOG(LogKantanDocGen, Display, TEXT("generating type members for : %s"), *Type->GetName());
+	const TSharedPtr<FDocFile>* DocFile = DocFiles.Find(Type->GetClass());
+	return DocFile && DocFile->IsValid() ? (*DocFile)->PrepareTypeMembers(Type) : nullptr;
+}
+
+bool FNodeDocsGenerator::CommitTypeMembers(UObject* Type, TSharedPtr<DocTreeNode> DocTree)
+{
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::CommitTypeMembers);
+	if (Type == nullptr)
 	{
-		UE_LOG(LogKantanDocGen, Display, TEXT("generating type members for : %s"), *Type->GetName());
-		for (const auto& DocFile : DocFiles)
+		return true;
+	}
+
+	UObject* DocumentedType = FDocGenManifest::GetDocumentedType(Type);
+	if (UpToDateTypes.Contains(DocumentedType))
+	{
+		// Only list it in the index if the previous run did generate docs for it
+		TSharedPtr<FDocFile> DocFile = FindDocFileForType(DocumentedType);
+		if (DocFile.IsValid() && IFileManager::Get().DirectoryExists(*(OutputDir / DocFile->GetDocDirectory(DocumentedType))))
 		{
-			if (Type->GetClass() != DocFile.Key)
+			DocFile->UpdateParentDocOnly(DocumentedType);
+		}
+		return true;
+	}
+
+	const TSharedPtr<FDocFile>* DocFile = DocFiles.Find(Type->GetClass());
+	return DocFile && DocFile->IsValid() ? (*DocFile)->CommitTypeMembers(Type, MoveTemp(DocTree)) : true;
+}
+
+bool FNodeDocsGenerator::ReleaseTypeDocs(UObject* Type)
+{
+	KANTANDOCGEN_TRACE_SCOPE(FNodeDocsGenerator::ReleaseTypeDocs);
+	UObject* DocumentedType = FDocGenManifest::GetDocumentedType(Type);
+	TSharedPtr<FDocFile> DocFile = FindDocFileForType(DocumentedType);
+	if (!DocFile.IsValid())
+	{
+		return true;
+	}
+
+	TArray<TFuture<bool>> Writes;
+	Writes.Add(DocFile->SaveAndReleaseDocTree(DocumentedType, OutputDir, OutputFormats));
+
+	// Variable docs are keyed by "ClassId/VariableId", @see SaveVariableDocFile
+	const FString ClassId = FDocGenHelper::GetDocId(DocumentedType);
+	const FString VariablePrefix = ClassId / TEXT("");
+	{
+		FScopeLock VariableLock(&VariableDocTreeLock);
+		for (auto It = VariableDocTreeMap.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().StartsWith(VariablePrefix, ESearchCase::CaseSensitive))
 				continue;
 
-			DocFile.Value->GenerateTypeMembers(Type);
-			break;
+			const FString VariableId = It.Key().RightChop(VariablePrefix.Len());
+			const FString DocPath = OutputDir / TEXT("Classes") / ClassId / TEXT("Variables") / VariableId;
+			AppendVariableImagePaths(It.Key(), *It.Value());
+			VariableImagePathMap.Remove(It.Key());
+			Writes.Add(FDocGenHelper::SerializeDocToFileAsync(MoveTemp(It.Value()), DocPath, VariableId, OutputFormats));
+			It.RemoveCurrent();
 		}
 	}
 
+	FScopeLock Lock(&PendingDocWritesLock);
+	for (TFuture<bool>& Write : Writes)
+	{
+		PendingDocWrites.Add(MoveTemp(Write));
+	}
 	return true;
 }
 
+FString FNodeDocsGenerator::GetTypeDocDirectory(UObject* Type) const
+{
+	TSharedPtr<FDocFile> DocFile = FindDocFileForType(Type);
+	return DocFile.IsValid() ? DocFile->GetDocDirectory(Type) : FString();
+}
+
+TSharedPtr<FDocFile> FNodeDocsGenerator::FindDocFileForType(UObject* Type) const
+{
+	if (Type == nullptr)
+		return nullptr;
+
+	for (const auto& DocFile : DocFiles)
+	{
+		// Not an exact match, so blueprint generated classes are handled by the class doc file
+		if (DocFile.Key && Type->IsA(DocFile.Key))
+			return DocFile.Value;
+	}
+	return nullptr;
+}
+
 bool FNodeDocsGenerator::SaveVariableDocFile(FString const& OutDir)
 {
 	// Don't use SerializeDocMap because it's a different process
+	TArray<TFuture<bool>> Writes;
+	Writes.Reserve(VariableDocTreeMap.Num());
 	for (const auto& Pair : VariableDocTreeMap)
 	{
 		const auto Variable = Pair.Value;
@@ -524,10 +962,11 @@ bool FNodeDocsGenerator::SaveVariableDocFile(FString const& OutDir)
 		const bool bSplitted = Pair.Key.Split("/", &ClassId, &VariableId);
 		check(bSplitted);
 		const auto DocPath = OutDir / "Classes" / ClassId / TEXT("Variables") / VariableId;
+		AppendVariableImagePaths(Pair.Key, *Variable);
 
-		FDocGenHelper::SerializeDocToFile(Variable, DocPath, VariableId, OutputFormats);
+		Writes.Add(FDocGenHelper::SerializeDocToFileAsync(Variable, DocPath, VariableId, OutputFormats));
 	}
-	return true;
+	return FDocGenHelper::WaitForDocWrites(Writes);
 }
 
 void FNodeDocsGenerator::AdjustNodeForSnapshot(UEdGraphNode* Node)
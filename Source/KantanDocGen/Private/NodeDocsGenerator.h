@@ -9,6 +9,13 @@
 #include "Modules/ModuleManager.h"
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "ImagePixelData.h"
+#include "DocGenImageCache.h"
+#include "DocGenRenderTargetPool.h"
+#include "HAL/CriticalSection.h"
+#include "ThreadingHelpers.h"
+
+#include <atomic>
 
 class UClass;
 class UBlueprint;
@@ -18,50 +25,148 @@ class UK2Node;
 class UBlueprintNodeSpawner;
 class FXmlFile;
 class FDocFile;
+class IImageWriteQueue;
+class SGraphNode;
+class SWidget;
 
 class FNodeDocsGenerator
 {
 public:
-	FNodeDocsGenerator(const TArray<class UDocGenOutputFormatFactoryBase*>& OutputFormats, const TArray<FName>& CustomMetaKeys);
+	FNodeDocsGenerator(const TArray<class UDocGenOutputFormatFactoryBase*>& OutputFormats, const TArray<FName>& CustomMetaKeys,
+					   bool bDeduplicateInheritedMembers = false);
 	~FNodeDocsGenerator();
 
 public:
+	// Everything needed to save a node image away from the game thread.
+	struct FNodeImage
+	{
+		// Atlas rendering: pixels of an atlas shared by several nodes.
+		struct FAtlasPixels
+		{
+			TArray<FColor> Pixels;
+			FIntPoint Size = FIntPoint::ZeroValue;
+		};
+
+		// Full path of the node image, known as soon as the node has been rendered. Empty if the node has no image.
+		FString SavePath;
+		// Key of the node image in the image cache, empty if the cache is disabled.
+		FString CacheKey;
+		// Pixels captured on the game thread, null if the node was rendered in an atlas or not rendered at all.
+		TUniquePtr<FImagePixelData> PixelData;
+		// Atlas the node was rendered in, and where.
+		TSharedPtr<const FAtlasPixels> Atlas;
+		FIntRect AtlasRect;
+	};
+
 	struct FNodeProcessingState
 	{
 		TSharedPtr<class DocTreeNode> ClassDocTree;
+		// Copied from the class doc tree on the game thread, so workers don't have to read the shared tree.
+		FString ClassId;
+		FString ClassName;
 		FString ClassDocsPath;
 		FString RelImageBasePath;
 		FString ImageFilename;
+		FNodeImage Image;
+		// Entry of the node in ClassDocTree, reserved on the game thread so the entries of a class keep the spawn order.
+		// Null if the node doesn't get an entry (events, or the variable already has one).
+		TSharedPtr<class DocTreeNode> ClassDocEntry;
 
 		FNodeProcessingState():
 			ClassDocTree()
+			, ClassId()
+			, ClassName()
 			, ClassDocsPath()
 			, RelImageBasePath()
 			, ImageFilename()
+			, Image()
 		{}
 	};
 
+	// A node spawned (and rendered) on the game thread, handed back to the processor thread as part of a batch.
+	struct FSpawnedNode
+	{
+		UK2Node* Node = nullptr;
+		FNodeProcessingState State;
+	};
+
 public:
+	// Reuse node images from previous runs when the node looks the same. Call before GT_Init.
+	void EnableImageCache(const FString& CacheDir);
+	const FDocGenImageCache* GetImageCache() const { return ImageCache.Get(); }
+
 	/** Callable only from game thread */
+	// Incremental builds: the docs generated for Type by the previous run are up to date. Its members and nodes won't
+	// be generated again, it only gets an entry in the index.
+	void GT_MarkTypeUpToDate(UObject* Type) { UpToDateTypes.Add(Type); }
+	// The type must be regenerated after all (e.g. a changed source adds nodes to it)
+	void GT_MarkTypeOutdated(UObject* Type) { UpToDateTypes.Remove(Type); }
+	bool GT_IsTypeUpToDate(const UObject* Type) const { return UpToDateTypes.Contains(Type); }
+	// Incremental builds: decides whether the nodes a source object spawns for a class are documented. Without it, only
+	// the nodes of the up to date types are skipped. Call before GT_Init.
+	using FNodeFilter = TFunction<bool(UClass* AssociatedClass, UObject* SourceObject)>;
+	void SetNodeFilter(FNodeFilter InNodeFilter) { NodeFilter = MoveTemp(InNodeFilter); }
 	bool GT_Init(FString const& InDocsTitle, FString const& InOutputDir, UClass* BlueprintContextClass = AActor::StaticClass());
 	UK2Node* GT_InitializeForSpawner(UBlueprintNodeSpawner* Spawner, UObject* SourceObject, FNodeProcessingState& OutState);
+	bool GT_RenderNodeImage(UEdGraphNode* Node, FNodeProcessingState& State);
+	// Renders the images of a batch of nodes, one by one or all in a few atlases. Nodes that failed are removed.
+	void GT_RenderNodeImages(TArray<FSpawnedNode>& Batch, bool bUseAtlas);
+	// Reserves the entries of the rendered nodes in their class doc tree, in batch order. Workers fill them.
+	void GT_ReserveClassDocEntries(TArray<FSpawnedNode>& Batch);
 	bool GT_Finalize(FString OutputPath);
 	/**/
 
-	/** Callable from background thread */
-	bool GenerateNodeImage(UEdGraphNode* Node, FNodeProcessingState& State);
+	/** Callable from any thread, concurrently */
+	// Queues the image on the engine image write queue (or copies it from the image cache when nothing was rendered),
+	// the future is fulfilled once the PNG is on disk.
+	TFuture<bool> GenerateNodeImage(FNodeImage&& Image);
+	// Blocks until every image queued so far has been written.
+	void WaitForImageWrites();
+	// Blocks until the type docs released so far have been written, returns false if any of them failed. Must be called
+	// before giving up on a run, so that nothing keeps writing to the output directory.
+	bool WaitForDocWrites();
 	bool GenerateNodeDocTree(UK2Node* Node, FNodeProcessingState& State);
 	bool GenerateVariableDocTree(UK2Node_Variable* Node, FNodeProcessingState& State);
+	/**/
+
+	/** Callable from background thread */
 	bool GenerateTypeMembers(UObject* Type);
+	// GenerateTypeMembers in two steps, so the members of several types can be prepared concurrently. Commits are
+	// made from one thread at a time, in enumeration order so the index doesn't depend on thread timings.
+	TSharedPtr<DocTreeNode> PrepareTypeMembers(UObject* Type);
+	bool CommitTypeMembers(UObject* Type, TSharedPtr<DocTreeNode> DocTree);
+	// Streaming finalize: writes the docs of Type and the docs of its variables in the background and releases their
+	// trees. Only the entry of Type in the index is kept until GT_Finalize. Its members must have been committed and
+	// its nodes processed, the ones spawned afterwards are skipped.
+	bool ReleaseTypeDocs(UObject* Type);
 	/**/
 
+	// Directory of the docs of a class/struct/enum, relative to the output directory (e.g. "Classes/Actor").
+	FString GetTypeDocDirectory(UObject* Type) const;
+	int32 GetNumUpToDateTypes() const { return UpToDateTypes.Num(); }
+
 protected:
 	void CleanUp();
 	bool SaveVariableDocFile(FString const& OutDir);
 
 	// @TODO: Move it in a FDocFile for K2Node class?
-	bool UpdateClassDocWithNode(TSharedPtr<DocTreeNode> DocTree, UEdGraphNode* Node);
-	bool UpdateClassDocWithVariable(TSharedPtr<DocTreeNode> DocTree, UK2Node_Variable* Node);
+	// Fill the entry reserved by GT_ReserveClassDocEntries
+	bool UpdateClassDocWithNode(TSharedPtr<DocTreeNode> ClassDocEntry, UEdGraphNode* Node);
+	bool UpdateClassDocWithVariable(TSharedPtr<DocTreeNode> ClassDocEntry, UK2Node_Variable* Node);
+
+	struct FAtlasEntry
+	{
+		int32 BatchIndex = INDEX_NONE;
+		TSharedPtr<SGraphNode> Widget;
+		FIntPoint Size = FIntPoint::ZeroValue;
+		FIntPoint Position = FIntPoint::ZeroValue;
+	};
+
+	// Returns true if the node image has to be rendered.
+	bool GT_PrepareNodeImage(UEdGraphNode* Node, FNodeProcessingState& State);
+	TSharedRef<SGraphNode> GT_CreateNodeWidget(UEdGraphNode* Node, FIntPoint& OutImageSize);
+	bool GT_DrawWidget(TSharedRef<SWidget> Widget, FIntPoint ImageSize, TArray<FColor>& OutPixels);
+	bool GT_RenderAtlas(TArrayView<FAtlasEntry*> Entries, FIntPoint AtlasSize, TArray<FSpawnedNode>& Batch);
 
 	static void AdjustNodeForSnapshot(UEdGraphNode* Node);
 	static UClass* MapToAssociatedClass(UK2Node* NodeInst, UObject* Source);
@@ -84,28 +189,57 @@ protected:
 		return StaticCastSharedPtr<T>(DocFiles[InstanceType]);
 	}
 
+	TSharedPtr<FDocFile> FindDocFileForType(UObject* Type) const;
+
 	TSharedPtr<DocTreeNode> GetVariableDocTree(const FString& VariableId, bool& bFound, bool bCreate = false);
+	// Adds the getter/setter images to a variable doc right before it is written, in a fixed order
+	void AppendVariableImagePaths(const FString& VariableId, DocTreeNode& VarDocTree) const;
 
 protected:
 	TWeakObjectPtr< UBlueprint > DummyBP;
 	TWeakObjectPtr< UEdGraph > Graph;
 	TSharedPtr< class SGraphPanel > GraphPanel;
+	TUniquePtr< class FWidgetRenderer > WidgetRenderer;
+	FDocGenRenderTargetPool RenderTargetPool;
+	int32 NumRenderFlushes = 0;
 
 	FString DocsTitle;
 	TSharedPtr<DocTreeNode> IndexTree;
 	// @TODO: use an FDocFile instead, but find a way to retrieve class id for saving files
 	TMap<FString, TSharedPtr<DocTreeNode>> VariableDocTreeMap;
+	// Getter and setter nodes of a variable are processed in any order, their images are only added on save
+	struct FVariableImagePaths
+	{
+		FString Getter;
+		FString Setter;
+	};
+	TMap<FString, FVariableImagePaths> VariableImagePathMap;
+	FCriticalSection VariableDocTreeLock;
+	// Variables whose entry in their class doc tree has been reserved, game thread only
+	TSet<FString> VariablesWithClassDocEntry;
+	// Streaming finalize: type docs being written in the background, joined by GT_Finalize. Bounded, so that releasing
+	// types doesn't get ahead of the writes (their trees are only freed once written).
+	DocGenThreads::FBoundedTaskQueue PendingDocWrites {64};
+	FCriticalSection PendingDocWritesLock;
+	// Node docs are written by the task generating them, failures are only reported by GT_Finalize
+	std::atomic<int32> NumFailedNodeDocWrites {0};
 	TArray<UDocGenOutputFormatFactoryBase*> OutputFormats;
 	FString OutputDir;
+	IImageWriteQueue* ImageWriteQueue = nullptr;
+	TUniquePtr<FDocGenImageCache> ImageCache;
+	TSet<const UObject*> UpToDateTypes;
+	FNodeFilter NodeFilter;
 	bool SaveAllFormats(FString const& OutDir, TSharedPtr<DocTreeNode> Document){ return false; };
 
 private:
 	TMap<UClass*, TSharedPtr<FDocFile>> DocFiles;
 
 public:
-	//
-	double GenerateNodeImageTime = 0.0;
-	double GenerateNodeDocsTime = 0.0;
+	// Cycles accumulated across all threads, @see DocGenThreads::CyclesToSeconds
+	std::atomic<uint64> RenderNodeImageCycles {0};
+	std::atomic<uint64> GenerateNodeDocsCycles {0};
+	// From queuing an image to it being on disk, including the time spent waiting in the image write queue
+	std::atomic<uint64> WriteNodeImageCycles {0};
 	//
 };
 
@@ -3,10 +3,17 @@
 #include "Misc/FileHelper.h"
 #include "OutputFormats/DocGenJsonOutputProcessor.h"
 #include "OutputFormats/DocGenOutputProcessor.h"
+#include "OutputFormats/DocGenUtf8FileWriter.h"
 
-FString DocGenJsonSerializer::EscapeString(const FString& InString) const
+namespace
 {
-	return InString;
+	// Keys are interned case sensitively, but fields are grouped ignoring case like the TMultiMap<FString> doc trees used to
+	struct FFieldKeyFuncs : TDefaultMapKeyFuncs<const FString*, int32, false>
+	{
+		static bool Matches(const FString* A, const FString* B) { return A == B || A->Equals(*B, ESearchCase::IgnoreCase); }
+		// Case insensitive
+		static uint32 GetKeyHash(const FString* Key) { return GetTypeHash(*Key); }
+	};
 }
 
 FString DocGenJsonSerializer::GetFileExtension() const
@@ -16,91 +23,194 @@ FString DocGenJsonSerializer::GetFileExtension() const
 
 void DocGenJsonSerializer::SerializeObject(const DocTreeNode::Object& Obj)
 {
-	TArray<FString> ObjectFieldNames;
-	// If we have a single key...
-	if (Obj.GetKeys(ObjectFieldNames) == 1)
-	{
-		TArray<TSharedPtr<DocTreeNode>> ArrayFieldValues;
-		// If that single key has multiple values...
-		Obj.MultiFind(ObjectFieldNames[0], ArrayFieldValues, true);
-		if (ArrayFieldValues.Num() > 1)
+	const FString* Identifier = PendingIdentifier;
+	PendingIdentifier = nullptr;
+	bTopLevel = false;
+
+	// Group the values by key in a single pass, keys are kept in the order (and case) they first appear
+	struct FField
+	{
+		const FString* Name;
+		TArray<const DocTreeNode*, TInlineAllocator<1>> Values;
+	};
+	TArray<FField, TInlineAllocator<16>> Fields;
+	TMap<const FString*, int32, TInlineSetAllocator<16>, FFieldKeyFuncs> FieldIndices;
+	for (const auto& Member : Obj)
+	{
+		int32 FieldIndex;
+		if (const int32* ExistingIndex = FieldIndices.Find(&Member.Key))
 		{
-			// we are an array
-			TargetObject = SerializeArray(ArrayFieldValues);
-			return;
+			FieldIndex = *ExistingIndex;
 		}
+		else
+		{
+			FieldIndex = Fields.Add(FField {&Member.Key});
+			FieldIndices.Add(&Member.Key, FieldIndex);
+		}
+		Fields[FieldIndex].Values.Add(Member.Value);
 	}
 
-	if (!TargetObject.IsValid())
+	// If we have a single key with multiple values, we are an array
+	if (Fields.Num() == 1 && Fields[0].Values.Num() > 1)
 	{
-		TargetObject = MakeShared<FJsonValueObject>(MakeShared<FJsonObject>());
+		SerializeArray(Identifier, Fields[0].Values);
+		return;
 	}
-	for (auto& FieldName : ObjectFieldNames)
+
+	Write([Identifier](auto& Writer) {
+		if (Identifier)
+		{
+			Writer.WriteObjectStart(*Identifier);
+		}
+		else
+		{
+			Writer.WriteObjectStart();
+		}
+	});
+
+	for (const FField& Field : Fields)
 	{
-		TArray<TSharedPtr<DocTreeNode>> ArrayFieldValues;
-		Obj.MultiFind(FieldName, ArrayFieldValues, true);
-		if (ArrayFieldValues.Num() > 1)
+		if (Field.Values.Num() > 1)
 		{
-			TargetObject->AsObject()->SetField(FieldName, SerializeArray(ArrayFieldValues));
+			SerializeArray(Field.Name, Field.Values);
 		}
 		else
 		{
-			TSharedPtr<FJsonValue> NewMemberValue;
-			ArrayFieldValues[0]->SerializeWith(MakeShared<DocGenJsonSerializer>(NewMemberValue));
-			TargetObject->AsObject()->SetField(FieldName, NewMemberValue);
+			PendingIdentifier = Field.Name;
+			Field.Values[0]->SerializeWith(AsShared());
 		}
 	}
+
+	Write([](auto& Writer) { Writer.WriteObjectEnd(); });
 }
 
-TSharedPtr<FJsonValueArray> DocGenJsonSerializer::SerializeArray(const TArray<TSharedPtr<DocTreeNode>> ArrayElements)
+void DocGenJsonSerializer::SerializeArray(const FString* Identifier, TArrayView<const DocTreeNode* const> ArrayElements)
 {
-	TArray<TSharedPtr<FJsonValue>> OutArray;
-	for (auto& Element : ArrayElements)
+	Write([Identifier](auto& Writer) {
+		if (Identifier)
+		{
+			Writer.WriteArrayStart(*Identifier);
+		}
+		else
+		{
+			Writer.WriteArrayStart();
+		}
+	});
+
+	for (const DocTreeNode* Element : ArrayElements)
 	{
-		TSharedPtr<FJsonValue> NewElementValue;
-		Element->SerializeWith(MakeShared<DocGenJsonSerializer>(NewElementValue));
-		OutArray.Add(NewElementValue);
+		Element->SerializeWith(AsShared());
 	}
-	return MakeShared<FJsonValueArray>(OutArray);
+
+	Write([](auto& Writer) { Writer.WriteArrayEnd(); });
 }
 
-void DocGenJsonSerializer::SerializeString(const FString& InString)
+void DocGenJsonSerializer::SerializeString(FStringView InString, bool bEscape)
 {
-	TargetObject = MakeShared<FJsonValueString>(InString);
+	const FString* Identifier = PendingIdentifier;
+	PendingIdentifier = nullptr;
+
+	bTopLevel = false;
+
+	// The writer escapes the strings itself
+	const FString Value(InString);
+	Write([Identifier, &Value](auto& Writer) {
+		if (Identifier)
+		{
+			Writer.WriteValue(*Identifier, Value);
+		}
+		else
+		{
+			Writer.WriteValue(Value);
+		}
+	});
 }
 
 void DocGenJsonSerializer::SerializeNull()
 {
-	TargetObject = MakeShared<FJsonValueNull>();
+	const FString* Identifier = PendingIdentifier;
+	PendingIdentifier = nullptr;
+
+	// An empty document is still an object
+	if (bTopLevel)
+	{
+		bTopLevel = false;
+		Write([](auto& Writer) {
+			Writer.WriteObjectStart();
+			Writer.WriteObjectEnd();
+		});
+		return;
+	}
+
+	Write([Identifier](auto& Writer) {
+		if (Identifier)
+		{
+			Writer.WriteNull(*Identifier);
+		}
+		else
+		{
+			Writer.WriteNull();
+		}
+	});
+}
+
+void DocGenJsonSerializer::CreateWriter(FArchive* Stream)
+{
+	if (bCompact)
+	{
+		using FFactory = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>;
+		CompactWriter = Stream ? FFactory::Create(Stream) : FFactory::Create(&Buffer);
+	}
+	else
+	{
+		using FFactory = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>;
+		PrettyWriter = Stream ? FFactory::Create(Stream) : FFactory::Create(&Buffer);
+	}
 }
 
-DocGenJsonSerializer::DocGenJsonSerializer()
-	: TopLevelObject(MakeShared<FJsonValueObject>(MakeShared<FJsonObject>())),
-	  TargetObject(TopLevelObject)
-{}
+DocGenJsonSerializer::DocGenJsonSerializer(bool bCompact) : bCompact(bCompact) {}
 
-DocGenJsonSerializer::DocGenJsonSerializer(TSharedPtr<FJsonValue>& TargetObject) : TargetObject(TargetObject) {}
+DocGenJsonSerializer::~DocGenJsonSerializer() = default;
 
-bool DocGenJsonSerializer::SaveToFile(const FString& OutFileDirectory, const FString& OutFileName)
+void DocGenJsonSerializer::BeginFile(const FString& OutFileDirectory, const FString& OutFileName)
 {
-	if (!TopLevelObject)
+	check(!PrettyWriter && !CompactWriter);
+
+	FileWriter = MakeUnique<FDocGenUtf8FileWriter>();
+	if (FileWriter->Open(OutFileDirectory / OutFileName + GetFileExtension()))
 	{
-		return false;
+		CreateWriter(FileWriter.Get());
 	}
 	else
 	{
-		FString Result;
-		auto JsonWriter = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Result);
-		FJsonSerializer::Serialize(TopLevelObject->AsObject().ToSharedRef(), JsonWriter);
+		// Buffer the document instead, SaveToFile will try again
+		FileWriter.Reset();
+	}
+}
+
+bool DocGenJsonSerializer::SaveToFile(const FString& OutFileDirectory, const FString& OutFileName)
+{
+	if (!PrettyWriter && !CompactWriter)
+	{
+		return false;
+	}
 
-		return FFileHelper::SaveStringToFile(Result, *(OutFileDirectory / OutFileName + GetFileExtension()),
-											 FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+	bool bComplete = false;
+	Write([&bComplete](auto& Writer) { bComplete = Writer.Close(); });
+
+	if (FileWriter)
+	{
+		// Already written to the file given to BeginFile
+		return FileWriter->Close() && bComplete;
 	}
+
+	return bComplete && FFileHelper::SaveStringToFile(Buffer, *(OutFileDirectory / OutFileName + GetFileExtension()),
+													  FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
 }
 
 TSharedPtr<struct DocTreeNode::IDocTreeSerializer> UDocGenJsonOutputFactory::CreateSerializer()
 {
-	return MakeShared<DocGenJsonSerializer>();
+	return MakeShared<DocGenJsonSerializer>(bCompactOutput);
 }
 
 TSharedPtr<struct IDocGenOutputProcessor> UDocGenJsonOutputFactory::CreateIntermediateDocProcessor()
@@ -155,6 +265,10 @@ void UDocGenJsonOutputFactory::LoadSettings(const FDocGenOutputFormatFactorySett
 			bOverrideRubyPath = (Settings.SettingValues["overrideruby"] == "true");
 		}
 	}
+	if (Settings.SettingValues.Contains("compact"))
+	{
+		bCompactOutput = (Settings.SettingValues["compact"] == "true");
+	}
 }
 
 FDocGenOutputFormatFactorySettings UDocGenJsonOutputFactory::SaveSettings()
@@ -178,6 +292,11 @@ FDocGenOutputFormatFactorySettings UDocGenJsonOutputFactory::SaveSettings()
 	}
 	Settings.SettingValues.Add("ruby", RubyPath.FilePath);
 
+	if (bCompactOutput)
+	{
+		Settings.SettingValues.Add("compact", "true");
+	}
+
 	Settings.FactoryClass = StaticClass();
 	return Settings;
 }
@@ -3,27 +3,62 @@
 #include "CoreMinimal.h"
 #include "DocTreeNode.h"
 #include "OutputFormats/DocGenOutputFormatFactoryBase.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
 #include "Templates/SharedPointer.h"
 
 #include "DocGenJsonOutputFormat.generated.h"
 
-class DocGenJsonSerializer : public DocTreeNode::IDocTreeSerializer
+// Streams the doc tree as JSON while walking it, without building a FJsonValue tree first.
+// An object with a single key holding multiple values is written as an array, keys holding multiple values as array fields.
+class DocGenJsonSerializer : public DocTreeNode::IDocTreeSerializer, public TSharedFromThis<DocGenJsonSerializer>
 {
-	TSharedPtr<class FJsonValue> TopLevelObject;
-	TSharedPtr<FJsonValue>& TargetObject;
+	using FPrettyWriter = TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>;
+	using FCompactWriter = TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>;
+
+	bool bCompact;
+	// Only one of them is used, depending on bCompact
+	TSharedPtr<FPrettyWriter> PrettyWriter;
+	TSharedPtr<FCompactWriter> CompactWriter;
+	// Set when streaming to a file (see BeginFile), otherwise the document is buffered until SaveToFile
+	TUniquePtr<class FDocGenUtf8FileWriter> FileWriter;
+	FString Buffer;
+	// Name of the field the next value is written to, null for array elements and the top level object
+	const FString* PendingIdentifier = nullptr;
+	// Nothing has been written yet
+	bool bTopLevel = true;
 
-	virtual FString EscapeString(const FString& InString) const override;
 	virtual FString GetFileExtension() const override;
 	virtual void SerializeObject(const DocTreeNode::Object& Obj) override;
 
-	TSharedPtr<class FJsonValueArray> SerializeArray(const TArray<TSharedPtr<DocTreeNode>> ArrayElements);
+	void SerializeArray(const FString* Identifier, TArrayView<const DocTreeNode* const> ArrayElements);
 
-	virtual void SerializeString(const FString& InString) override;
+	virtual void SerializeString(FStringView InString, bool bEscape) override;
 	virtual void SerializeNull() override;
 
+	void CreateWriter(FArchive* Stream);
+	template <typename FunctorType>
+	void Write(FunctorType&& Func)
+	{
+		if (!PrettyWriter && !CompactWriter)
+		{
+			CreateWriter(nullptr);
+		}
+		if (PrettyWriter)
+		{
+			Func(*PrettyWriter);
+		}
+		else
+		{
+			Func(*CompactWriter);
+		}
+	}
+
 public:
-	DocGenJsonSerializer(TSharedPtr<FJsonValue>& TargetObject);;
-	DocGenJsonSerializer();
+	DocGenJsonSerializer(bool bCompact = false);
+	virtual ~DocGenJsonSerializer();
+	virtual void BeginFile(const FString& OutFileDirectory, const FString& OutFileName) override;
 	virtual bool SaveToFile(const FString& OutFileDirectory, const FString& OutFileName);;
 };
 
@@ -58,4 +93,8 @@ public:
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (EditCondition = "bOverrideRubyPath"))
 	FFilePath RubyPath;
+
+	// Write the intermediate json files without indentation and line breaks
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bCompactOutput = false;
 };
\ No newline at end of file
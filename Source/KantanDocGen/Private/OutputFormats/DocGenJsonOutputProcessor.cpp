@@ -1,5 +1,6 @@
 #include "OutputFormats/DocGenJsonOutputProcessor.h"
 #include "Algo/Transform.h"
+#include "Async/ParallelFor.h"
 #include "HAL/FileManager.h"
 
 // To define the UE_5_0_OR_LATER below
@@ -13,6 +14,7 @@
 #include "Json.h"
 #include "JsonDomBuilder.h"
 #include "KantanDocGenLog.h"
+#include "KantanDocGenTrace.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Optional.h"
 #include "Misc/Paths.h"
@@ -342,6 +344,7 @@ EIntermediateProcessingResult DocGenJsonOutputProcessor::ProcessIntermediateDocs
 																				 FString const& DocTitle,
 																				 bool bCleanOutput)
 {
+	KANTANDOCGEN_TRACE_SCOPE(DocGenJsonOutputProcessor::ProcessIntermediateDocs);
 	TSharedPtr<FJsonObject> ParsedIndex = LoadFileToJson(IntermediateDir / "index.json");
 
 	TSharedPtr<FJsonObject> ConsolidatedOutput = InitializeMainOutputFromIndex(ParsedIndex);
@@ -388,6 +391,7 @@ EIntermediateProcessingResult DocGenJsonOutputProcessor::ConsolidateClasses(TSha
 																			FString const& OutputDir,
 																			TSharedPtr<FJsonObject> ConsolidatedOutput)
 {
+	KANTANDOCGEN_TRACE_SCOPE(DocGenJsonOutputProcessor::ConsolidateClasses);
 	FJsonDomBuilder::FArray StaticFunctionList;
 	FJsonDomBuilder::FObject ClassFunctionList;
 	TOptional<TArray<FString>> ClassNames = GetNamesFromIndexFile("classes", ParsedIndex);
@@ -396,62 +400,99 @@ EIntermediateProcessingResult DocGenJsonOutputProcessor::ConsolidateClasses(TSha
 		return EIntermediateProcessingResult::UnknownError;
 	}
 
-	for (const auto& ClassName : ClassNames.GetValue())
+	// Files are loaded and parsed in parallel, then merged in the order of the index and of the class files, so
+	// consolidated.json doesn't depend on the scheduling.
+	const TArray<FString>& Classes = ClassNames.GetValue();
+	TArray<TOptional<TArray<FString>>> ClassNodeNames;
+	ClassNodeNames.SetNum(Classes.Num());
+	ParallelFor(Classes.Num(), [this, &Classes, &ClassNodeNames, &IntermediateDir](int32 Index) {
+		const FString ClassFilePath = IntermediateDir / Classes[Index] / Classes[Index] + ".json";
+		ClassNodeNames[Index] = GetNamesFromFileAtLocation("nodes", ClassFilePath);
+	});
+
+	struct FNodeFile
+	{
+		int32 ClassIndex;
+		const FString* NodeName;
+		TSharedPtr<FJsonObject> Json;
+		// Relative to the class directory, empty if the node has no image
+		FString ImagePath;
+	};
+	TArray<FNodeFile> NodeFiles;
+	for (int32 ClassIndex = 0; ClassIndex < Classes.Num(); ++ClassIndex)
+	{
+		if (!ClassNodeNames[ClassIndex].IsSet())
+		{
+			return EIntermediateProcessingResult::UnknownError;
+		}
+		for (const FString& NodeName : ClassNodeNames[ClassIndex].GetValue())
+		{
+			NodeFiles.Add({ClassIndex, &NodeName});
+		}
+	}
+
+	ParallelFor(NodeFiles.Num(), [this, &Classes, &NodeFiles, &IntermediateDir](int32 Index) {
+		static const FString ImagePathFieldName(TEXT("imgpath"));
+
+		FNodeFile& NodeFile = NodeFiles[Index];
+		const FString& ClassName = Classes[NodeFile.ClassIndex];
+		NodeFile.Json = ParseNodeFile(IntermediateDir / ClassName / "nodes" / *NodeFile.NodeName + ".json");
+		if (NodeFile.Json)
+		{
+			NodeFile.Json->TryGetStringField(ImagePathFieldName, NodeFile.ImagePath);
+		}
+	});
+
+	// Nodes may share an image name, the last one wins as when copying them one after the other
+	TMap<FString, FString> ImageCopies;
+	for (const FNodeFile& NodeFile : NodeFiles)
 	{
-		const FString ClassFilePath = IntermediateDir / ClassName / ClassName + ".json";
-		TOptional<TArray<FString>> NodeNames = GetNamesFromFileAtLocation("nodes", ClassFilePath);
-		if (!NodeNames.IsSet())
+		if (!NodeFile.Json)
 		{
 			return EIntermediateProcessingResult::UnknownError;
 		}
-		else
+		if (!NodeFile.ImagePath.IsEmpty())
 		{
-			TOptional<FString> NodeClassID;
-			FJsonDomBuilder::FArray Nodes;
-			for (const auto& NodeName : NodeNames.GetValue())
+			const FString SourceImagePath = IntermediateDir / Classes[NodeFile.ClassIndex] / "nodes" / NodeFile.ImagePath;
+			ImageCopies.Add(OutputDir / "img" / FPaths::GetCleanFilename(NodeFile.ImagePath),
+							IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*SourceImagePath));
+		}
+	}
+
+	TArray<TPair<FString, FString>> ImageCopyList = ImageCopies.Array();
+	ParallelFor(ImageCopyList.Num(), [&ImageCopyList](int32 Index) {
+		IFileManager::Get().Copy(*ImageCopyList[Index].Key, *ImageCopyList[Index].Value, true);
+	});
+
+	int32 NodeFileIndex = 0;
+	for (int32 ClassIndex = 0; ClassIndex < Classes.Num(); ++ClassIndex)
+	{
+		static const FString StaticFieldName(TEXT("static"));
+
+		FJsonDomBuilder::FArray Nodes;
+		for (; NodeFileIndex < NodeFiles.Num() && NodeFiles[NodeFileIndex].ClassIndex == ClassIndex; ++NodeFileIndex)
+		{
+			const TSharedPtr<FJsonObject>& NodeJson = NodeFiles[NodeFileIndex].Json;
+			bool FunctionIsStatic = false;
+			NodeJson->TryGetBoolField(StaticFieldName, FunctionIsStatic);
+
+			if (FunctionIsStatic)
 			{
-				const FString NodeFilePath = IntermediateDir / ClassName / "nodes" / NodeName + ".json";
-
-				static const FString ImagePathFieldName(TEXT("imgpath"));
-				static const FString StaticFieldName(TEXT("static"));
-
-				if (TSharedPtr<FJsonObject> NodeJson = ParseNodeFile(NodeFilePath))
-				{
-					FString RelImagePath;
-					if (NodeJson->TryGetStringField(ImagePathFieldName, RelImagePath))
-					{
-						FString SourceImagePath = IntermediateDir / ClassName / "nodes" / RelImagePath;
-						SourceImagePath =
-							IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*SourceImagePath);
-						IFileManager::Get().Copy(*(OutputDir / "img" / FPaths::GetCleanFilename(RelImagePath)),
-												 *SourceImagePath, true);
-					}
-					bool FunctionIsStatic = false;
-					NodeJson->TryGetBoolField(StaticFieldName, FunctionIsStatic);
-
-					if (FunctionIsStatic)
-					{
-						StaticFunctionList.Add(MakeShared<FJsonValueObject>(NodeJson));
-					}
-					else
-					{
-						Nodes.Add(MakeShared<FJsonValueObject>(NodeJson));
-					}
-				}
-				else
-				{
-					return EIntermediateProcessingResult::UnknownError;
-				}
+				StaticFunctionList.Add(MakeShared<FJsonValueObject>(NodeJson));
 			}
-			// We don't want classes in our classlist if all their nodes are static
-			if (Nodes.Num())
+			else
 			{
-				FJsonDomBuilder::FObject ClassObj;
-				ClassObj.Set("functions", Nodes);
-				ClassObj.Set("class_id", ClassName);
-				ClassFunctionList.Set(ClassName, ClassObj);
+				Nodes.Add(MakeShared<FJsonValueObject>(NodeJson));
 			}
 		}
+		// We don't want classes in our classlist if all their nodes are static
+		if (Nodes.Num())
+		{
+			FJsonDomBuilder::FObject ClassObj;
+			ClassObj.Set("functions", Nodes);
+			ClassObj.Set("class_id", Classes[ClassIndex]);
+			ClassFunctionList.Set(Classes[ClassIndex], ClassObj);
+		}
 	}
 
 	ConsolidatedOutput->SetField("functions", StaticFunctionList.AsJsonValue());
@@ -472,17 +513,102 @@ EIntermediateProcessingResult DocGenJsonOutputProcessor::ConsolidateStructs(TSha
 		return EIntermediateProcessingResult::UnknownError;
 	}
 
-	for (const auto& StructName : StructNames.GetValue())
+	const TArray<FString>& Structs = StructNames.GetValue();
+	TArray<TSharedPtr<FJsonObject>> StructJsons;
+	StructJsons.SetNum(Structs.Num());
+	ParallelFor(Structs.Num(), [this, &Structs, &StructJsons, &IntermediateDir](int32 Index) {
+		StructJsons[Index] = ParseStructFile(IntermediateDir / Structs[Index] / Structs[Index] + ".json");
+	});
+
+	TMap<FString, TSharedPtr<FJsonObject>> StructsById;
+	for (int32 Index = 0; Index < Structs.Num(); ++Index)
 	{
-		const FString StructFilePath = IntermediateDir / StructName / StructName + ".json";
-		TSharedPtr<FJsonObject> StructJson = ParseStructFile(StructFilePath);
-		StructList.Add(MakeShared<FJsonValueObject>(StructJson));
+		StructsById.Add(Structs[Index], StructJsons[Index]);
+		StructList.Add(MakeShared<FJsonValueObject>(StructJsons[Index]));
+	}
+
+	for (const TSharedPtr<FJsonObject>& StructJson : StructJsons)
+	{
+		ResolveInheritedFields(StructJson, IntermediateDir, StructsById);
 	}
 
 	ConsolidatedOutput->SetField("structs", StructList.AsJsonValue());
 	return EIntermediateProcessingResult::Success;
 }
 
+TArray<TSharedPtr<FJsonObject>> DocGenJsonOutputProcessor::GetFieldObjects(TSharedPtr<FJsonObject> StructJson)
+{
+	TArray<TSharedPtr<FJsonObject>> Fields;
+	const TSharedPtr<FJsonValue> FieldsValue = StructJson ? StructJson->TryGetField(TEXT("fields")) : nullptr;
+	if (!FieldsValue)
+	{
+		return Fields;
+	}
+
+	// Several fields are serialized as an array, a single one as an object holding it
+	const TArray<TSharedPtr<FJsonValue>>* FieldArray;
+	const TSharedPtr<FJsonObject>* FieldsObject;
+	if (FieldsValue->TryGetArray(FieldArray))
+	{
+		for (const auto& Field : *FieldArray)
+		{
+			const TSharedPtr<FJsonObject>* FieldObject;
+			if (Field->TryGetObject(FieldObject))
+			{
+				Fields.Add(*FieldObject);
+			}
+		}
+	}
+	else if (FieldsValue->TryGetObject(FieldsObject))
+	{
+		const TSharedPtr<FJsonObject>* FieldObject;
+		if ((*FieldsObject)->TryGetObjectField(TEXT("field"), FieldObject))
+		{
+			Fields.Add(*FieldObject);
+		}
+	}
+	return Fields;
+}
+
+void DocGenJsonOutputProcessor::ResolveInheritedFields(TSharedPtr<FJsonObject> StructJson, FString const& IntermediateDir,
+													   TMap<FString, TSharedPtr<FJsonObject>>& StructsById)
+{
+	for (const TSharedPtr<FJsonObject>& Field : GetFieldObjects(StructJson))
+	{
+		// Fields inherited with the deduplicated mode only hold their name, the full entry is in the doc of the owner
+		const TSharedPtr<FJsonObject>* InheritedFrom;
+		if (Field->HasField(TEXT("display_name")) || !Field->TryGetObjectField(TEXT("inheritedFrom"), InheritedFrom))
+		{
+			continue;
+		}
+
+		const TOptional<FString> OwnerId = GetObjectStringField(*InheritedFrom, TEXT("id"));
+		const TOptional<FString> Name = GetObjectStringField(Field, TEXT("name"));
+		if (!OwnerId.IsSet() || !Name.IsSet())
+		{
+			continue;
+		}
+
+		// The owner may not be in the index (e.g. a struct without any blueprint visible field of its own)
+		if (!StructsById.Contains(OwnerId.GetValue()))
+		{
+			const FString OwnerFilePath = IntermediateDir / OwnerId.GetValue() / OwnerId.GetValue() + ".json";
+			StructsById.Add(OwnerId.GetValue(), ParseStructFile(OwnerFilePath));
+		}
+
+		for (const TSharedPtr<FJsonObject>& OwnerField : GetFieldObjects(StructsById[OwnerId.GetValue()]))
+		{
+			if (GetObjectStringField(OwnerField, TEXT("name")) == Name)
+			{
+				const TSharedPtr<FJsonValue> InheritedFromValue = Field->TryGetField(TEXT("inheritedFrom"));
+				Field->Values = OwnerField->Values;
+				Field->SetField(TEXT("inheritedFrom"), InheritedFromValue);
+				break;
+			}
+		}
+	}
+}
+
 EIntermediateProcessingResult DocGenJsonOutputProcessor::ConsolidateEnums(TSharedPtr<FJsonObject> ParsedIndex,
 																		  FString const& IntermediateDir,
 																		  FString const& OutputDir,
@@ -496,10 +622,15 @@ EIntermediateProcessingResult DocGenJsonOutputProcessor::ConsolidateEnums(TShare
 		return EIntermediateProcessingResult::UnknownError;
 	}
 
-	for (const auto& EnumName : EnumNames.GetValue())
+	const TArray<FString>& Enums = EnumNames.GetValue();
+	TArray<TSharedPtr<FJsonObject>> EnumJsons;
+	EnumJsons.SetNum(Enums.Num());
+	ParallelFor(Enums.Num(), [this, &Enums, &EnumJsons, &IntermediateDir](int32 Index) {
+		EnumJsons[Index] = ParseEnumFile(IntermediateDir / Enums[Index] / Enums[Index] + ".json");
+	});
+
+	for (const TSharedPtr<FJsonObject>& EnumJson : EnumJsons)
 	{
-		const FString EnumFilePath = IntermediateDir / EnumName / EnumName + ".json";
-		TSharedPtr<FJsonObject> EnumJson = ParseEnumFile(EnumFilePath);
 		EnumList.Add(MakeShared<FJsonValueObject>(EnumJson));
 	}
 
@@ -20,6 +20,11 @@ class DocGenJsonOutputProcessor : public IDocGenOutputProcessor
 
 	TSharedPtr<FJsonObject> ParseStructFile(const FString& StructFilePath);
 	TSharedPtr<FJsonObject> ParseEnumFile(const FString& EnumFilePath);
+	// Fields of a parsed struct file
+	TArray<TSharedPtr<FJsonObject>> GetFieldObjects(TSharedPtr<FJsonObject> StructJson);
+	// Replaces the references to inherited fields by the entry of the struct declaring them
+	void ResolveInheritedFields(TSharedPtr<FJsonObject> StructJson, FString const& IntermediateDir,
+								TMap<FString, TSharedPtr<FJsonObject>>& StructsById);
 	void CopyJsonField(const FString& FieldName, TSharedPtr<FJsonObject> ParsedNode, TSharedPtr<FJsonObject> OutNode);
 	TSharedPtr<FJsonObject> InitializeMainOutputFromIndex(TSharedPtr<FJsonObject> ParsedIndex);
 	EIntermediateProcessingResult ConvertJsonToAdoc(FString IntermediateDir);
@@ -0,0 +1,1045 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "OutputFormats/DocGenMarkdownOutputFormat.h"
+#include "Algo/StableSort.h"
+#include "HAL/FileManager.h"
+#include "Json.h"
+#include "KantanDocGenLog.h"
+#include "KantanDocGenTrace.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "OutputFormats/DocGenMarkdownOutputProcessor.h"
+#include "OutputFormats/DocGenUtf8FileWriter.h"
+
+// The pages mirror the TransmuDoc stylesheets (ThirdParty/TransmuDoc/xslt), keep them in sync.
+namespace
+{
+	using FObject = DocTreeNode::Object;
+
+	TOptional<FString> FindString(const FObject& Obj, const TCHAR* Key)
+	{
+		const DocTreeNode* Child = Obj.Find(Key);
+		const TOptional<FStringView> Value = Child ? Child->TryGetString() : NullOpt;
+		return Value ? TOptional<FString>(FString(*Value)) : NullOpt;
+	}
+
+	// Empty if there is no such string
+	FString GetString(const FObject& Obj, const TCHAR* Key)
+	{
+		const DocTreeNode* Child = Obj.Find(Key);
+		return Child ? FString(Child->GetValue()) : FString();
+	}
+
+	bool GetBool(const FObject& Obj, const TCHAR* Key)
+	{
+		return GetString(Obj, Key) == TEXT("true");
+	}
+
+	const FObject* FindObject(const FObject& Obj, const TCHAR* Key)
+	{
+		const DocTreeNode* Child = Obj.Find(Key);
+		return Child ? Child->TryGetObject() : nullptr;
+	}
+
+	// Children with the given key, in document order (unlike TMultiMap::MultiFind)
+	TArray<const FObject*> GetObjects(const FObject* Obj, const TCHAR* Key)
+	{
+		TArray<const FObject*> Objects;
+		if (Obj)
+		{
+			for (const auto& Pair : *Obj)
+			{
+				const FObject* Child = Pair.Value->TryGetObject();
+				if (Child && Pair.Key.Equals(Key, ESearchCase::CaseSensitive))
+				{
+					Objects.Add(Child);
+				}
+			}
+		}
+		return Objects;
+	}
+
+	int32 CompareStrings(const FObject& A, const FObject& B, const TCHAR* Key)
+	{
+		return GetString(A, Key).Compare(GetString(B, Key), ESearchCase::CaseSensitive);
+	}
+
+	// Same as an xsl:sort on each key in turn (stable, codepoint order, missing values first)
+	void SortObjects(TArray<const FObject*>& Objects, std::initializer_list<const TCHAR*> Keys)
+	{
+		Algo::StableSort(Objects, [&Keys](const FObject* A, const FObject* B) {
+			for (const TCHAR* Key : Keys)
+			{
+				if (const int32 Result = CompareStrings(*A, *B, Key))
+				{
+					return Result < 0;
+				}
+			}
+			return false;
+		});
+	}
+
+	FString GetInheritedFromId(const FObject& Member)
+	{
+		const FObject* InheritedFrom = FindObject(Member, TEXT("inheritedFrom"));
+		return InheritedFrom ? GetString(*InheritedFrom, TEXT("id")) : FString();
+	}
+
+	// Own members first, then grouped by the class they are inherited from
+	void SortMembers(TArray<const FObject*>& Members)
+	{
+		Algo::StableSort(Members, [](const FObject* A, const FObject* B) {
+			if (const int32 Result = GetInheritedFromId(*A).Compare(GetInheritedFromId(*B), ESearchCase::CaseSensitive))
+			{
+				return Result < 0;
+			}
+			if (const int32 Result = CompareStrings(*A, *B, TEXT("category")))
+			{
+				return Result < 0;
+			}
+			return CompareStrings(*A, *B, TEXT("display_name")) < 0;
+		});
+	}
+
+	// Text usable in a table cell
+	FString Format(const FString& Input)
+	{
+		return Input.Replace(TEXT("<"), TEXT("&lt;"))
+			.Replace(TEXT(">"), TEXT("&gt;"))
+			.Replace(TEXT("\r\n"), TEXT("\n"))
+			.Replace(TEXT("\n"), TEXT("<br/>"));
+	}
+
+	FString NoWrap(const FString& Input)
+	{
+		return Input.Replace(TEXT(" "), TEXT("&nbsp;"));
+	}
+
+	// Categories are separated by '|'
+	FString OneLine(const FString& Input)
+	{
+		return Input.Replace(TEXT("|"), TEXT(" &#8594; "));
+	}
+
+	FString MultiLine(const FString& Input)
+	{
+		return Input.Replace(TEXT("|"), TEXT(" <br/>\u2514 "));
+	}
+
+	void AppendLink(FString& Out, const FString& Name, const FString& Href)
+	{
+		Out += TEXT("[");
+		Out += Name;
+		Out += TEXT("](");
+		Out += Href;
+		Out += TEXT(")");
+	}
+
+	void AppendImage(FString& Out, const FString& Href)
+	{
+		Out += TEXT("![](");
+		Out += Href;
+		Out += TEXT(")");
+	}
+
+	FString GetPageLink(const TCHAR* Directory, const FString& Id)
+	{
+		return FString::Printf(TEXT("./%s/%s/%s.md"), Directory, *Id, *Id);
+	}
+
+	struct FFrontmatterField
+	{
+		const TCHAR* Name;
+		FString Value;
+	};
+
+	// Fields are written in the order given, custom fields (name and value entries) last
+	void AppendFrontmatter(FString& Out, std::initializer_list<FFrontmatterField> Fields,
+						   TArrayView<const FObject* const> CustomFields = {})
+	{
+		Out += TEXT("---");
+		for (const auto& Field : Fields)
+		{
+			Out += TEXT("\n");
+			Out += Field.Name;
+			Out += TEXT(": ");
+			Out += Field.Value;
+		}
+		for (const FObject* Field : CustomFields)
+		{
+			Out += TEXT("\n");
+			Out += GetString(*Field, TEXT("name")).ToLower();
+			Out += TEXT(": ");
+			Out += GetString(*Field, TEXT("value"));
+		}
+		Out += TEXT("\n---\n\n");
+	}
+
+	struct FBreadcrumbItem
+	{
+		FString Name;
+		FString Href;
+	};
+
+	// The last item is the current page, it isn't linked
+	void AppendBreadcrumb(FString& Out, std::initializer_list<FBreadcrumbItem> Items)
+	{
+		int32 Index = 0;
+		for (const auto& Item : Items)
+		{
+			if (++Index < static_cast<int32>(Items.size()))
+			{
+				AppendLink(Out, Item.Name, Item.Href);
+				Out += TEXT(" \u23F5\n");
+			}
+			else
+			{
+				Out += Item.Name;
+			}
+		}
+		Out += TEXT("\n");
+	}
+
+	void AppendTitle(FString& Out, const FString& Title)
+	{
+		Out += TEXT("\n# ");
+		Out += Title;
+		Out += TEXT("\n");
+	}
+
+	void AppendDescription(FString& Out, const FObject& Root)
+	{
+		const FString Description = GetString(Root, TEXT("description"));
+		if (!Description.IsEmpty())
+		{
+			Out += TEXT("\n## Description\n\n");
+			Out += Format(Description);
+			Out += TEXT("\n");
+		}
+	}
+
+	void AppendTableHeader(FString& Out, const TCHAR* Title, std::initializer_list<const TCHAR*> Columns)
+	{
+		Out += TEXT("\n## ");
+		Out += Title;
+		Out += TEXT("\n\n|");
+		FString Separator = TEXT("|");
+		for (const TCHAR* Column : Columns)
+		{
+			Out += TEXT(" ");
+			Out += Column;
+			Out += TEXT(" |");
+			Separator += TEXT(" ") + FString::ChrN(FCString::Strlen(Column), TEXT('-')) + TEXT(" |");
+		}
+		Out += TEXT("\n");
+		Out += Separator;
+		Out += TEXT("\n");
+	}
+
+	void AppendDisplayName(FString& Out, const FObject& Obj)
+	{
+		Out += NoWrap(Format(GetString(Obj, TEXT("display_name"))));
+	}
+
+	void AppendExposedAs(FString& Out, const FObject& Obj, const TCHAR* Separator)
+	{
+		const bool bBlueprintable = GetBool(Obj, TEXT("blueprintable"));
+		const bool bBlueprintType = GetBool(Obj, TEXT("blueprint_type"));
+		if (bBlueprintable)
+		{
+			Out += TEXT("Blueprint&nbsp;Base&nbsp;Class");
+		}
+		if (bBlueprintable && bBlueprintType)
+		{
+			Out += Separator;
+		}
+		if (bBlueprintType)
+		{
+			Out += TEXT("Variable&nbsp;Type");
+		}
+	}
+
+	void AppendInheritedFrom(FString& Out, const FObject& Member)
+	{
+		if (const FObject* InheritedFrom = FindObject(Member, TEXT("inheritedFrom")))
+		{
+			Out += TEXT("<br/>(inherited from ");
+			AppendDisplayName(Out, *InheritedFrom);
+			Out += TEXT(")");
+		}
+	}
+
+	// Members inherited with the deduplicated mode only hold their name
+	bool IsMemberReference(const FObject& Member)
+	{
+		return !Member.Contains(TEXT("display_name")) && Member.Contains(TEXT("inheritedFrom"));
+	}
+
+	const TCHAR* MemberReferencePrefix = TEXT("<!-- kantandocgen:inherited\t");
+	const TCHAR* MemberReferenceSuffix = TEXT(" -->\n");
+	// Starts the rows of inherited members rendered before the documented types are known, followed by the owner id
+	const TCHAR* InheritedRowPrefix = TEXT("<!-- kantandocgen:inheritedrow\t");
+	const TCHAR* InheritedRowSuffix = TEXT(" -->");
+
+	// Strips the markers of the inherited rows, and the rows inherited from types that aren't documented
+	FString FilterInheritedRows(const FString& Page, const TSet<FString>* DocumentedClassIds)
+	{
+		const FString Prefix(InheritedRowPrefix);
+		const FString Suffix(InheritedRowSuffix);
+		if (!Page.Contains(Prefix, ESearchCase::CaseSensitive))
+		{
+			return Page;
+		}
+
+		FString Out;
+		Out.Reserve(Page.Len());
+		int32 Start = 0;
+		int32 MarkerStart;
+		while ((MarkerStart = Page.Find(Prefix, ESearchCase::CaseSensitive, ESearchDir::FromStart, Start)) != INDEX_NONE)
+		{
+			const int32 MarkerEnd = Page.Find(Suffix, ESearchCase::CaseSensitive, ESearchDir::FromStart, MarkerStart);
+			if (MarkerEnd == INDEX_NONE)
+			{
+				break;
+			}
+			Out += Page.Mid(Start, MarkerStart - Start);
+			Start = MarkerEnd + Suffix.Len();
+
+			const int32 OwnerIdStart = MarkerStart + Prefix.Len();
+			const FString OwnerId = Page.Mid(OwnerIdStart, MarkerEnd - OwnerIdStart);
+			if (DocumentedClassIds && !DocumentedClassIds->Contains(OwnerId))
+			{
+				const int32 RowEnd = Page.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Start);
+				Start = RowEnd == INDEX_NONE ? Page.Len() : RowEnd + 1;
+			}
+		}
+		Out += Page.Mid(Start);
+		return Out;
+	}
+
+	// Cells after the name one of the rows whose member can't be found
+	FString GetEmptyCells(const FString& Table)
+	{
+		const int32 NumCells = Table == TEXT("events") ? 2 : 4;
+		FString Cells;
+		for (int32 Index = 0; Index < NumCells; ++Index)
+		{
+			Cells += TEXT(" | ");
+		}
+		Cells += TEXT(" |\n");
+		return Cells;
+	}
+
+	void AppendParamTable(FString& Out, const TCHAR* Title, const FObject* Params)
+	{
+		AppendTableHeader(Out, Title, {TEXT("Name"), TEXT("Type"), TEXT("Description")});
+		for (const FObject* Param : GetObjects(Params, TEXT("param")))
+		{
+			Out += TEXT("| ");
+			Out += GetString(*Param, TEXT("name"));
+			Out += TEXT(" | ");
+			Out += GetString(*Param, TEXT("type"));
+			Out += TEXT(" | ");
+			Out += Format(GetString(*Param, TEXT("description")));
+			Out += TEXT(" |\n");
+		}
+	}
+
+	// Class, category and access fields of the node and variable pages
+	void AppendMemberDetails(FString& Out, const FObject& Root)
+	{
+		const FString ClassId = GetString(Root, TEXT("class_id"));
+		Out += TEXT("\n**Class:** ");
+		AppendLink(Out, NoWrap(OneLine(GetString(Root, TEXT("class_name")))), TEXT("../../") + ClassId + TEXT(".md"));
+		Out += TEXT("\\\n**Category:** ");
+		Out += NoWrap(OneLine(GetString(Root, TEXT("category"))));
+	}
+} // namespace
+
+const TCHAR* FDocGenMarkdownMemberTable::SavedRowsSuffix = TEXT(".rows.json");
+
+void FDocGenMarkdownMemberTable::AddRow(const TCHAR* Table, const FString& OwnerId, const FString& Name, FRow&& Row)
+{
+	FString Key = MakeKey(Table, Name);
+	FScopeLock ScopeLock(&Lock);
+	Rows.FindOrAdd(OwnerId).Add(MoveTemp(Key), MoveTemp(Row));
+}
+
+bool FDocGenMarkdownMemberTable::SaveRows(const FString& OwnerId, const FString& Path) const
+{
+	TArray<TSharedPtr<FJsonValue>> RowValues;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (const TMap<FString, FRow>* OwnerRows = Rows.Find(OwnerId))
+		{
+			for (const auto& Pair : *OwnerRows)
+			{
+				TSharedRef<FJsonObject> RowObject = MakeShared<FJsonObject>();
+				RowObject->SetStringField(TEXT("key"), Pair.Key);
+				RowObject->SetStringField(TEXT("category"), Pair.Value.Category);
+				RowObject->SetStringField(TEXT("display_name"), Pair.Value.DisplayName);
+				RowObject->SetStringField(TEXT("cells"), Pair.Value.Cells);
+				RowValues.Add(MakeShared<FJsonValueObject>(RowObject));
+			}
+		}
+	}
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("owner"), OwnerId);
+	Root->SetArrayField(TEXT("rows"), RowValues);
+
+	FString Content;
+	if (!FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Content)) ||
+		!FFileHelper::SaveStringToFile(Content, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to save the member rows of %s to %s"), *OwnerId, *Path);
+		return false;
+	}
+	return true;
+}
+
+void FDocGenMarkdownMemberTable::LoadSavedRows(const FString& IntermediateDir)
+{
+	KANTANDOCGEN_TRACE_SCOPE(FDocGenMarkdownMemberTable::LoadSavedRows);
+	TArray<FString> Files;
+	IFileManager::Get().FindFilesRecursive(Files, *IntermediateDir, *(FString(TEXT("*")) + SavedRowsSuffix), true, false);
+
+	FScopeLock ScopeLock(&Lock);
+	for (const FString& File : Files)
+	{
+		FString Content;
+		TSharedPtr<FJsonObject> Root;
+		if (!FFileHelper::LoadFileToString(Content, *File) ||
+			!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Content), Root) || !Root.IsValid())
+		{
+			UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to load the member rows saved in %s"), *File);
+			continue;
+		}
+
+		// The rows of this run are the up to date ones
+		const FString OwnerId = Root->GetStringField(TEXT("owner"));
+		if (Rows.Contains(OwnerId))
+		{
+			continue;
+		}
+
+		TMap<FString, FRow>& OwnerRows = Rows.Add(OwnerId);
+		const TArray<TSharedPtr<FJsonValue>>* RowValues = nullptr;
+		if (Root->TryGetArrayField(TEXT("rows"), RowValues))
+		{
+			for (const TSharedPtr<FJsonValue>& RowValue : *RowValues)
+			{
+				const TSharedPtr<FJsonObject>* RowObject = nullptr;
+				if (RowValue->TryGetObject(RowObject))
+				{
+					OwnerRows.Add((*RowObject)->GetStringField(TEXT("key")),
+								  {(*RowObject)->GetStringField(TEXT("category")),
+								   (*RowObject)->GetStringField(TEXT("display_name")),
+								   (*RowObject)->GetStringField(TEXT("cells"))});
+				}
+			}
+		}
+	}
+}
+
+FString FDocGenMarkdownMemberTable::ResolveReferences(const FString& InPage, const TSet<FString>* DocumentedClassIds) const
+{
+	const FString Page = FilterInheritedRows(InPage, DocumentedClassIds);
+	const FString Prefix(MemberReferencePrefix);
+	const FString Suffix(MemberReferenceSuffix);
+	if (!Page.Contains(Prefix, ESearchCase::CaseSensitive))
+	{
+		return Page;
+	}
+
+	FString Out;
+	Out.Reserve(Page.Len());
+	int32 Start = 0;
+	int32 ReferenceStart;
+	while ((ReferenceStart = Page.Find(Prefix, ESearchCase::CaseSensitive, ESearchDir::FromStart, Start)) != INDEX_NONE)
+	{
+		const int32 ReferenceEnd = Page.Find(Suffix, ESearchCase::CaseSensitive, ESearchDir::FromStart, ReferenceStart);
+		if (ReferenceEnd == INDEX_NONE)
+		{
+			break;
+		}
+		Out += Page.Mid(Start, ReferenceStart - Start);
+		Start = ReferenceEnd + Suffix.Len();
+
+		// Table, owner id, owner display name, then the names of the members
+		TArray<FString> Values;
+		const int32 ValuesStart = ReferenceStart + Prefix.Len();
+		Page.Mid(ValuesStart, ReferenceEnd - ValuesStart).ParseIntoArray(Values, TEXT("\t"), false);
+		if (Values.Num() < 3 || (DocumentedClassIds && !DocumentedClassIds->Contains(Values[1])))
+		{
+			continue;
+		}
+
+		struct FResolvedRow
+		{
+			const FString* Name;
+			const FRow* Row;
+		};
+		TArray<FResolvedRow> ResolvedRows;
+		const TMap<FString, FRow>* OwnerRows = Rows.Find(Values[1]);
+		for (int32 Index = 3; Index < Values.Num(); ++Index)
+		{
+			ResolvedRows.Add({&Values[Index], OwnerRows ? OwnerRows->Find(MakeKey(Values[0], Values[Index])) : nullptr});
+		}
+
+		// Same order as the rows of the owner page, missing values first
+		static const FString NoValue;
+		Algo::StableSort(ResolvedRows, [](const FResolvedRow& A, const FResolvedRow& B) {
+			const FString& CategoryA = A.Row ? A.Row->Category : NoValue;
+			const FString& CategoryB = B.Row ? B.Row->Category : NoValue;
+			if (const int32 Result = CategoryA.Compare(CategoryB, ESearchCase::CaseSensitive))
+			{
+				return Result < 0;
+			}
+			const FString& DisplayNameA = A.Row ? A.Row->DisplayName : NoValue;
+			const FString& DisplayNameB = B.Row ? B.Row->DisplayName : NoValue;
+			return DisplayNameA.Compare(DisplayNameB, ESearchCase::CaseSensitive) < 0;
+		});
+
+		for (const FResolvedRow& Resolved : ResolvedRows)
+		{
+			Out += TEXT("| ");
+			Out += NoWrap(Format(Resolved.Row ? Resolved.Row->DisplayName : *Resolved.Name));
+			Out += TEXT("<br/>(inherited from ");
+			Out += Values[2];
+			Out += TEXT(")");
+			Out += Resolved.Row ? Resolved.Row->Cells : GetEmptyCells(Values[0]);
+		}
+	}
+	Out += Page.Mid(Start);
+	return Out;
+}
+
+FString FDocGenMarkdownMemberTable::MakeReference(const TCHAR* Table, const FString& OwnerId,
+												 const FString& OwnerDisplayName, const TArray<FString>& Names)
+{
+	FString Reference = MemberReferencePrefix;
+	Reference += Table;
+	Reference += TEXT("\t");
+	Reference += OwnerId;
+	Reference += TEXT("\t");
+	Reference += NoWrap(Format(OwnerDisplayName));
+	for (const FString& Name : Names)
+	{
+		Reference += TEXT("\t");
+		Reference += Name;
+	}
+	Reference += MemberReferenceSuffix;
+	return Reference;
+}
+
+FString FDocGenMarkdownMemberTable::MakeKey(const FString& Table, const FString& Name)
+{
+	return Table / Name;
+}
+
+DocGenMarkdownSerializer::DocGenMarkdownSerializer(TSharedPtr<const TSet<FString>> InDocumentedClassIds,
+												   TSharedPtr<FDocGenMarkdownMemberTable> InMemberTable)
+	: DocumentedClassIds(MoveTemp(InDocumentedClassIds))
+	, MemberTable(MoveTemp(InMemberTable))
+{}
+
+FString DocGenMarkdownSerializer::GetFileExtension() const
+{
+	return TEXT(".md");
+}
+
+void DocGenMarkdownSerializer::SerializeObject(const DocTreeNode::Object& Obj)
+{
+	// Only the top level object is given, the pages are rendered from it once the whole tree is known
+	check(!Root);
+	Root = &Obj;
+}
+
+void DocGenMarkdownSerializer::SerializeString(FStringView InString, bool bEscape) {}
+
+void DocGenMarkdownSerializer::SerializeNull() {}
+
+bool DocGenMarkdownSerializer::SaveToFile(const FString& OutFileDirectory, const FString& OutFileName)
+{
+	KANTANDOCGEN_TRACE_SCOPE(DocGenMarkdownSerializer::SaveToFile);
+	if (!Root)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Nothing to render for %s"), *OutFileName);
+		return false;
+	}
+
+	FString Out;
+	const FString DocType = GetString(*Root, TEXT("doctype"));
+	if (DocType == TEXT("index"))
+	{
+		RenderIndex(Out);
+	}
+	else if (DocType == TEXT("class") || DocType == TEXT("struct") || DocType == TEXT("enum"))
+	{
+		RenderType(Out);
+	}
+	else if (DocType == TEXT("node"))
+	{
+		RenderNode(Out);
+	}
+	else if (DocType == TEXT("variable"))
+	{
+		RenderVariable(Out);
+	}
+	else
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("No markdown page for doc type: %s"), *DocType);
+		return false;
+	}
+
+	FDocGenUtf8FileWriter FileWriter;
+	if (!FileWriter.Open(OutFileDirectory / OutFileName + GetFileExtension()))
+	{
+		return false;
+	}
+	FileWriter.Write(Out);
+	if (!FileWriter.Close())
+	{
+		return false;
+	}
+
+	if (DocType == TEXT("class") || DocType == TEXT("struct"))
+	{
+		return MemberTable->SaveRows(GetString(*Root, TEXT("id")),
+									 OutFileDirectory / OutFileName + FDocGenMarkdownMemberTable::SavedRowsSuffix);
+	}
+	return true;
+}
+
+void DocGenMarkdownSerializer::RenderIndex(FString& Out) const
+{
+	AppendFrontmatter(Out, {
+		{TEXT("title"), TEXT("API References")},
+		{TEXT("description"), TEXT("Documentation for classes, enums, structs, nodes, etc.")},
+		{TEXT("sidebar_class_name"), TEXT("hidden")},
+	});
+	Out += TEXT("# ");
+	Out += GetString(*Root, TEXT("display_name"));
+	Out += TEXT(" API\n");
+
+	if (const FObject* Classes = FindObject(*Root, TEXT("classes")))
+	{
+		AppendTableHeader(Out, TEXT("Classes"),
+						  {TEXT("Type"), TEXT("Name"), TEXT("Category"), TEXT("Exposed As"), TEXT("Description")});
+		TArray<const FObject*> Rows = GetObjects(Classes, TEXT("class"));
+		Algo::StableSort(Rows, [](const FObject* A, const FObject* B) {
+			// Descending type first
+			if (const int32 Result = CompareStrings(*A, *B, TEXT("type")))
+			{
+				return Result > 0;
+			}
+			return CompareStrings(*A, *B, TEXT("display_name")) < 0;
+		});
+		for (const FObject* Row : Rows)
+		{
+			Out += TEXT("| ");
+			Out += GetString(*Row, TEXT("type"));
+			Out += TEXT(" | ");
+			AppendLink(Out, GetString(*Row, TEXT("display_name")), GetPageLink(TEXT("Classes"), GetString(*Row, TEXT("id"))));
+			Out += TEXT(" | ");
+			Out += NoWrap(GetString(*Row, TEXT("group")));
+			Out += TEXT(" | ");
+			AppendExposedAs(Out, *Row, TEXT("<br/>"));
+			Out += TEXT(" | ");
+			Out += Format(GetString(*Row, TEXT("description")));
+			Out += TEXT(" |\n");
+		}
+	}
+
+	auto AppendTypeTable = [this, &Out](const TCHAR* ListKey, const TCHAR* Key, const TCHAR* Title) {
+		const FObject* Types = FindObject(*Root, ListKey);
+		if (!Types)
+		{
+			return;
+		}
+
+		AppendTableHeader(Out, Title, {TEXT("Type"), TEXT("Name"), TEXT("Exposed As"), TEXT("Description")});
+		TArray<const FObject*> Rows = GetObjects(Types, Key);
+		SortObjects(Rows, {TEXT("display_name")});
+		for (const FObject* Row : Rows)
+		{
+			Out += TEXT("| ");
+			Out += GetString(*Row, TEXT("type"));
+			Out += TEXT(" | ");
+			AppendLink(Out, GetString(*Row, TEXT("display_name")), GetPageLink(Title, GetString(*Row, TEXT("id"))));
+			Out += TEXT(" | ");
+			if (GetBool(*Row, TEXT("blueprint_type")))
+			{
+				Out += TEXT("Variable&nbsp;Type");
+			}
+			Out += TEXT(" | ");
+			Out += Format(GetString(*Row, TEXT("description")));
+			Out += TEXT(" |\n");
+		}
+	};
+	AppendTypeTable(TEXT("structs"), TEXT("struct"), TEXT("Structs"));
+	AppendTypeTable(TEXT("enums"), TEXT("enum"), TEXT("Enums"));
+}
+
+void DocGenMarkdownSerializer::RenderType(FString& Out) const
+{
+	const TArray<const FObject*> MetaEntries = GetObjects(FindObject(*Root, TEXT("meta")), TEXT("entry"));
+	if (Root->Contains(TEXT("meta")))
+	{
+		AppendFrontmatter(Out, {}, MetaEntries);
+	}
+
+	const FString DisplayName = GetString(*Root, TEXT("display_name"));
+	AppendBreadcrumb(Out, {
+		{GetString(*Root, TEXT("docs_name")), TEXT("../../index.md")},
+		{DisplayName, FString()},
+	});
+	AppendTitle(Out, DisplayName);
+
+	Out += TEXT("\n## Class Details\n\n");
+	if (const TOptional<FString> SourcePath = FindString(*Root, TEXT("sourcepath")))
+	{
+		Out += TEXT("**Defined in:** `");
+		Out += *SourcePath;
+		Out += TEXT("`");
+	}
+	if (const TOptional<FString> ClassTree = FindString(*Root, TEXT("classTree")))
+	{
+		Out += TEXT("\\\n**Hierarchy:** *");
+		Out += ClassTree->Replace(TEXT(">"), TEXT("&rarr;"));
+		Out += TEXT("*");
+	}
+	if (Root->Contains(TEXT("interfaces")))
+	{
+		Out += TEXT("\\\n**Implements:** ");
+		const TArray<const FObject*> Interfaces = GetObjects(FindObject(*Root, TEXT("interfaces")), TEXT("interface"));
+		for (int32 Index = 0; Index < Interfaces.Num(); ++Index)
+		{
+			const FString Id = GetString(*Interfaces[Index], TEXT("id"));
+			AppendLink(Out, GetString(*Interfaces[Index], TEXT("display_name")), TEXT("../") + Id + TEXT("/") + Id + TEXT(".md"));
+			if (Index < Interfaces.Num() - 1)
+			{
+				Out += TEXT(", ");
+			}
+		}
+	}
+	if (GetBool(*Root, TEXT("blueprint_type")) || GetBool(*Root, TEXT("blueprintable")))
+	{
+		Out += TEXT("\\\n**Exposed in blueprint as:** ");
+		AppendExposedAs(Out, *Root, TEXT(" | "));
+	}
+	Out += TEXT("\n");
+
+	AppendDescription(Out, *Root);
+
+	if (const FObject* Events = FindObject(*Root, TEXT("events")))
+	{
+		RenderEventTable(Out, *Events);
+	}
+
+	if (const FObject* Fields = FindObject(*Root, TEXT("fields")))
+	{
+		RenderFieldTable(Out, *Fields);
+	}
+
+	if (const FObject* Nodes = FindObject(*Root, TEXT("nodes")))
+	{
+		AppendTableHeader(Out, TEXT("Nodes"), {TEXT("Name"), TEXT("Category"), TEXT("Description")});
+		TArray<const FObject*> Rows = GetObjects(Nodes, TEXT("node"));
+		SortObjects(Rows, {TEXT("category"), TEXT("fulltitle")});
+		for (const FObject* Row : Rows)
+		{
+			Out += TEXT("| ");
+			AppendLink(Out, GetString(*Row, TEXT("fulltitle")), GetPageLink(TEXT("Nodes"), GetString(*Row, TEXT("id"))));
+			Out += TEXT(" | ");
+			Out += NoWrap(MultiLine(GetString(*Row, TEXT("category"))));
+			Out += TEXT(" | ");
+			Out += Format(GetString(*Row, TEXT("description")));
+			Out += TEXT(" |\n");
+		}
+	}
+
+	if (const FObject* Values = FindObject(*Root, TEXT("values")))
+	{
+		AppendTableHeader(Out, TEXT("Values"), {TEXT("Name"), TEXT("Description")});
+		for (const FObject* Row : GetObjects(Values, TEXT("value")))
+		{
+			Out += TEXT("| ");
+			Out += GetString(*Row, TEXT("displayname"));
+			Out += TEXT(" | ");
+			Out += Format(GetString(*Row, TEXT("description")));
+			Out += TEXT(" |\n");
+		}
+	}
+}
+
+bool DocGenMarkdownSerializer::IsMemberDocumented(const DocTreeNode::Object& Member) const
+{
+	const FString InheritedFromId = GetInheritedFromId(Member);
+	// Unknown until the index is complete (e.g. type docs written by the streaming finalize), the rows are filtered
+	// by the output processor then, @see AppendRowStart
+	return InheritedFromId.IsEmpty() || !DocumentedClassIds || DocumentedClassIds->Contains(InheritedFromId);
+}
+
+void DocGenMarkdownSerializer::AppendRowStart(FString& Out, const DocTreeNode::Object& Member) const
+{
+	const FString InheritedFromId = GetInheritedFromId(Member);
+	if (!DocumentedClassIds && !InheritedFromId.IsEmpty())
+	{
+		Out += InheritedRowPrefix;
+		Out += InheritedFromId;
+		Out += InheritedRowSuffix;
+	}
+	Out += TEXT("| ");
+}
+
+int32 DocGenMarkdownSerializer::AppendMemberReferences(FString& Out, const TCHAR* Table,
+													   TArrayView<const DocTreeNode::Object* const> Members) const
+{
+	const FObject* InheritedFrom = FindObject(*Members[0], TEXT("inheritedFrom"));
+	const FString OwnerId = GetInheritedFromId(*Members[0]);
+	TArray<FString> Names;
+	for (const FObject* Member : Members)
+	{
+		if (!IsMemberReference(*Member) || GetInheritedFromId(*Member) != OwnerId)
+		{
+			break;
+		}
+		Names.Add(GetString(*Member, TEXT("name")));
+	}
+
+	Out += FDocGenMarkdownMemberTable::MakeReference(Table, OwnerId, GetString(*InheritedFrom, TEXT("display_name")), Names);
+	return Names.Num();
+}
+
+void DocGenMarkdownSerializer::AddMemberRow(const TCHAR* Table, const DocTreeNode::Object& Member, FString&& Cells) const
+{
+	if (!Member.Contains(TEXT("inheritedFrom")))
+	{
+		MemberTable->AddRow(Table, GetString(*Root, TEXT("id")), GetString(Member, TEXT("name")),
+							{GetString(Member, TEXT("category")), GetString(Member, TEXT("display_name")), MoveTemp(Cells)});
+	}
+}
+
+void DocGenMarkdownSerializer::RenderEventTable(FString& Out, const DocTreeNode::Object& Events) const
+{
+	AppendTableHeader(Out, TEXT("Events"), {TEXT("Name"), TEXT("Category"), TEXT("Description")});
+	TArray<const FObject*> Rows = GetObjects(&Events, TEXT("event"));
+	Rows.RemoveAll([this](const FObject* Row) { return !IsMemberDocumented(*Row); });
+	SortMembers(Rows);
+	for (int32 Index = 0; Index < Rows.Num();)
+	{
+		if (IsMemberReference(*Rows[Index]))
+		{
+			Index += AppendMemberReferences(Out, TEXT("events"), MakeArrayView(Rows).Slice(Index, Rows.Num() - Index));
+			continue;
+		}
+
+		const FObject* Row = Rows[Index++];
+		AppendRowStart(Out, *Row);
+		AppendDisplayName(Out, *Row);
+		AppendInheritedFrom(Out, *Row);
+
+		FString Cells = TEXT(" | ");
+		Cells += NoWrap(MultiLine(GetString(*Row, TEXT("category"))));
+		Cells += TEXT(" | ");
+		Cells += Format(GetString(*Row, TEXT("description")));
+		Cells += TEXT(" |\n");
+		Out += Cells;
+		AddMemberRow(TEXT("events"), *Row, MoveTemp(Cells));
+	}
+}
+
+void DocGenMarkdownSerializer::RenderFieldTable(FString& Out, const DocTreeNode::Object& Fields) const
+{
+	AppendTableHeader(Out, TEXT("Properties"),
+					  {TEXT("Name"), TEXT("Type"), TEXT("Category"), TEXT("Accessors"), TEXT("Description")});
+
+	// Variables with their own page
+	TSet<FString> VariableIds;
+	for (const FObject* Variable : GetObjects(FindObject(*Root, TEXT("variables")), TEXT("variable")))
+	{
+		VariableIds.Add(GetString(*Variable, TEXT("id")));
+	}
+
+	TArray<const FObject*> Rows = GetObjects(&Fields, TEXT("field"));
+	Rows.RemoveAll([this](const FObject* Row) { return !IsMemberDocumented(*Row); });
+	SortMembers(Rows);
+	for (int32 Index = 0; Index < Rows.Num();)
+	{
+		if (IsMemberReference(*Rows[Index]))
+		{
+			Index += AppendMemberReferences(Out, TEXT("fields"), MakeArrayView(Rows).Slice(Index, Rows.Num() - Index));
+			continue;
+		}
+
+		const FObject* Row = Rows[Index++];
+		const FString Name = GetString(*Row, TEXT("name"));
+		AppendRowStart(Out, *Row);
+		if (VariableIds.Contains(Name))
+		{
+			AppendLink(Out, GetString(*Row, TEXT("display_name")), GetPageLink(TEXT("Variables"), Name));
+		}
+		else
+		{
+			AppendDisplayName(Out, *Row);
+		}
+		AppendInheritedFrom(Out, *Row);
+
+		FString Cells = TEXT(" | ");
+		Cells += Format(GetString(*Row, TEXT("type")));
+		Cells += TEXT(" | ");
+		Cells += NoWrap(MultiLine(GetString(*Row, TEXT("category"))));
+		Cells += TEXT(" | ");
+		const TOptional<FString> BlueprintAccess = FindString(*Row, TEXT("blueprint_access"));
+		const TOptional<FString> EditorAccess = FindString(*Row, TEXT("editor_access"));
+		if (BlueprintAccess)
+		{
+			Cells += NoWrap(TEXT("Blueprint ") + *BlueprintAccess);
+		}
+		if (BlueprintAccess && EditorAccess)
+		{
+			Cells += TEXT("<br/>");
+		}
+		if (EditorAccess)
+		{
+			Cells += NoWrap(TEXT("Edit ") + *EditorAccess);
+		}
+		Cells += TEXT(" | ");
+		Cells += Format(GetString(*Row, TEXT("description")));
+		Cells += TEXT(" |\n");
+		Out += Cells;
+		AddMemberRow(TEXT("fields"), *Row, MoveTemp(Cells));
+	}
+}
+
+void DocGenMarkdownSerializer::RenderNode(FString& Out) const
+{
+	const FString ClassId = GetString(*Root, TEXT("class_id"));
+	const FString FullTitle = GetString(*Root, TEXT("fulltitle"));
+	AppendFrontmatter(Out, {{TEXT("slug"), TEXT("/api/") + ClassId + TEXT("/") + GetString(*Root, TEXT("funcname"))}});
+	AppendBreadcrumb(Out, {
+		{GetString(*Root, TEXT("docs_name")), TEXT("../../../../index.md")},
+		{GetString(*Root, TEXT("class_name")), TEXT("../../") + ClassId + TEXT(".md")},
+		{FullTitle, FString()},
+	});
+	AppendTitle(Out, FullTitle);
+
+	AppendMemberDetails(Out, *Root);
+	Out += TEXT("\n");
+	AppendDescription(Out, *Root);
+
+	Out += TEXT("\nNode\n\n");
+	AppendImage(Out, GetString(*Root, TEXT("imgpath")));
+	Out += TEXT("\n\nC++\n");
+	if (const TOptional<FString> Signature = FindString(*Root, TEXT("rawsignature")))
+	{
+		Out += TEXT("\n```cpp\n");
+		Out += *Signature;
+		Out += TEXT("\n```\n");
+	}
+
+	if (const FObject* Inputs = FindObject(*Root, TEXT("inputs")))
+	{
+		AppendParamTable(Out, TEXT("Inputs"), Inputs);
+	}
+	if (const FObject* Outputs = FindObject(*Root, TEXT("outputs")))
+	{
+		AppendParamTable(Out, TEXT("Outputs"), Outputs);
+	}
+}
+
+void DocGenMarkdownSerializer::RenderVariable(FString& Out) const
+{
+	const FString ClassId = GetString(*Root, TEXT("class_id"));
+	const FString DisplayName = GetString(*Root, TEXT("display_name"));
+	AppendFrontmatter(Out, {{TEXT("slug"), TEXT("/api/") + ClassId + TEXT("/") + GetString(*Root, TEXT("id"))}});
+	AppendBreadcrumb(Out, {
+		{GetString(*Root, TEXT("docs_name")), TEXT("../../../../index.md")},
+		{GetString(*Root, TEXT("class_name")), TEXT("../../") + ClassId + TEXT(".md")},
+		{DisplayName, FString()},
+	});
+	AppendTitle(Out, DisplayName);
+
+	AppendMemberDetails(Out, *Root);
+	Out += TEXT("\\\n**Type:** ");
+	Out += NoWrap(OneLine(GetString(*Root, TEXT("variable_type"))));
+	if (const TOptional<FString> EditorAccess = FindString(*Root, TEXT("editor_access")))
+	{
+		Out += TEXT("\\\n**Editor Access:** ");
+		Out += NoWrap(OneLine(*EditorAccess));
+	}
+	if (const TOptional<FString> BlueprintAccess = FindString(*Root, TEXT("blueprint_access")))
+	{
+		Out += TEXT("\\\n**Blueprint Access:** ");
+		Out += NoWrap(OneLine(*BlueprintAccess));
+	}
+	Out += TEXT("\n");
+	AppendDescription(Out, *Root);
+
+	Out += TEXT("\n#### Nodes\n\n");
+	const TOptional<FString> GetterImage = FindString(*Root, TEXT("imgpath_get"));
+	const TOptional<FString> SetterImage = FindString(*Root, TEXT("imgpath_set"));
+	if (GetterImage)
+	{
+		AppendImage(Out, *GetterImage);
+	}
+	if (GetterImage && SetterImage)
+	{
+		Out += TEXT(" ");
+	}
+	if (SetterImage)
+	{
+		AppendImage(Out, *SetterImage);
+	}
+	Out += TEXT("\n");
+}
+
+TSharedPtr<struct DocTreeNode::IDocTreeSerializer> UDocGenMarkdownOutputFactory::CreateSerializer()
+{
+	FScopeLock ScopeLock(&SharedStateLock);
+	return MakeShared<DocGenMarkdownSerializer>(DocumentedClassIds, MemberTable);
+}
+
+TSharedPtr<struct IDocGenOutputProcessor> UDocGenMarkdownOutputFactory::CreateIntermediateDocProcessor()
+{
+	// The rows of this run go to the processor, the next run starts with a new table
+	FScopeLock ScopeLock(&SharedStateLock);
+	TSharedPtr<FDocGenMarkdownMemberTable> RunMemberTable = MoveTemp(MemberTable);
+	MemberTable = MakeShared<FDocGenMarkdownMemberTable>();
+	return MakeShared<DocGenMarkdownOutputProcessor>(MoveTemp(RunMemberTable), DocumentedClassIds);
+}
+
+FString UDocGenMarkdownOutputFactory::GetFormatIdentifier()
+{
+	return "markdown";
+}
+
+void UDocGenMarkdownOutputFactory::LoadSettings(const FDocGenOutputFormatFactorySettings& Settings) {}
+
+FDocGenOutputFormatFactorySettings UDocGenMarkdownOutputFactory::SaveSettings()
+{
+	FDocGenOutputFormatFactorySettings Settings;
+	Settings.FactoryClass = StaticClass();
+	return Settings;
+}
+
+void UDocGenMarkdownOutputFactory::BeginFinalize(TSharedPtr<const DocTreeNode> IndexDocTree)
+{
+	// A new set, serializers created before keep the one they were given
+	TSharedPtr<TSet<FString>> ClassIds = MakeShared<TSet<FString>>();
+	if (const FObject* Index = IndexDocTree.IsValid() ? IndexDocTree->TryGetObject() : nullptr)
+	{
+		for (const FObject* Class : GetObjects(FindObject(*Index, TEXT("classes")), TEXT("class")))
+		{
+			ClassIds->Add(GetString(*Class, TEXT("id")));
+		}
+	}
+	FScopeLock ScopeLock(&SharedStateLock);
+	DocumentedClassIds = ClassIds;
+}
@@ -0,0 +1,117 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#pragma once
+#include "Containers/Set.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "DocTreeNode.h"
+#include "HAL/CriticalSection.h"
+#include "OutputFormats/DocGenOutputFormatFactoryBase.h"
+
+#include "DocGenMarkdownOutputFormat.generated.h"
+
+// Rows of the properties and events of the type pages. Members inherited with the deduplicated mode only reference
+// the row of the type declaring them, the references are replaced once every page is written.
+class FDocGenMarkdownMemberTable
+{
+public:
+	struct FRow
+	{
+		FString Category;
+		FString DisplayName;
+		// Every cell after the name one, up to the end of the line
+		FString Cells;
+	};
+
+	// Thread safe
+	void AddRow(const TCHAR* Table, const FString& OwnerId, const FString& Name, FRow&& Row);
+	// Thread safe. Writes the rows of a type next to its page, so that they are still known by the incremental builds
+	// keeping that page.
+	bool SaveRows(const FString& OwnerId, const FString& Path) const;
+	// Adds the rows saved by the previous runs for the types whose page wasn't rendered by this run
+	void LoadSavedRows(const FString& IntermediateDir);
+
+	// Only called once every page is written. Members whose row can't be found only get their name. Members inherited
+	// from a type missing from DocumentedClassIds are left out, if given.
+	FString ResolveReferences(const FString& Page, const TSet<FString>* DocumentedClassIds) const;
+
+	// Line standing for the rows inherited from a type, in a page written before the rows of that type are known
+	static FString MakeReference(const TCHAR* Table, const FString& OwnerId, const FString& OwnerDisplayName,
+								 const TArray<FString>& Names);
+
+	// Appended to the page path of a type to get the one of its saved rows
+	static const TCHAR* SavedRowsSuffix;
+
+private:
+	static FString MakeKey(const FString& Table, const FString& Name);
+
+	// Keyed on the owner id, then on the table and member name
+	TMap<FString, TMap<FString, FRow>> Rows;
+	mutable FCriticalSection Lock;
+};
+
+// Renders the doc trees directly as Docusaurus markdown pages, the same ones TransmuDoc produces from the XML docs.
+class DocGenMarkdownSerializer : public DocTreeNode::IDocTreeSerializer
+{
+	// Ids of the classes listed in the index, members inherited from other classes are left out of the type pages.
+	// Null if the index isn't complete yet, the output processor leaves them out then.
+	TSharedPtr<const TSet<FString>> DocumentedClassIds;
+	TSharedPtr<FDocGenMarkdownMemberTable> MemberTable;
+	// Top level object of the doc tree being serialized, rendered by SaveToFile
+	const DocTreeNode::Object* Root = nullptr;
+
+	virtual FString GetFileExtension() const override;
+	virtual void SerializeObject(const DocTreeNode::Object& Obj) override;
+	// Values are read from the tree directly and formatted depending on where they end up in the page
+	virtual void SerializeString(FStringView InString, bool bEscape) override;
+	virtual void SerializeNull() override;
+
+	void RenderIndex(FString& Out) const;
+	void RenderType(FString& Out) const;
+	void RenderNode(FString& Out) const;
+	void RenderVariable(FString& Out) const;
+
+	bool IsMemberDocumented(const DocTreeNode::Object& Member) const;
+	// Starts the row of a member, marking it with its owner if it's inherited and the documented types aren't known yet
+	void AppendRowStart(FString& Out, const DocTreeNode::Object& Member) const;
+	// Appends a reference to the rows of the first members, as long as they only reference the same type.
+	// Returns the number of members referenced.
+	int32 AppendMemberReferences(FString& Out, const TCHAR* Table, TArrayView<const DocTreeNode::Object* const> Members) const;
+	// Registers the row of a member declared by the rendered type, for the pages referencing it
+	void AddMemberRow(const TCHAR* Table, const DocTreeNode::Object& Member, FString&& Cells) const;
+	void RenderEventTable(FString& Out, const DocTreeNode::Object& Events) const;
+	void RenderFieldTable(FString& Out, const DocTreeNode::Object& Fields) const;
+
+public:
+	DocGenMarkdownSerializer(TSharedPtr<const TSet<FString>> InDocumentedClassIds,
+							 TSharedPtr<FDocGenMarkdownMemberTable> InMemberTable);
+	virtual bool SaveToFile(const FString& OutFileDirectory, const FString& OutFileName) override;
+};
+
+UCLASS(meta = (DisplayName = "Markdown (Docusaurus)"), Meta = (ShowOnlyInnerProperties))
+class UDocGenMarkdownOutputFactory : public UDocGenOutputFormatFactoryBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual TSharedPtr<struct DocTreeNode::IDocTreeSerializer> CreateSerializer() override;
+	virtual TSharedPtr<struct IDocGenOutputProcessor> CreateIntermediateDocProcessor() override;
+	virtual FString GetFormatIdentifier() override;
+
+	virtual void LoadSettings(const FDocGenOutputFormatFactorySettings& Settings) override;
+	virtual FDocGenOutputFormatFactorySettings SaveSettings() override;
+
+	virtual void BeginFinalize(TSharedPtr<const DocTreeNode> IndexDocTree) override;
+
+private:
+	// Set by BeginFinalize, also handed over to the output processor
+	TSharedPtr<const TSet<FString>> DocumentedClassIds;
+	// Handed over to the output processor, which resolves the member references
+	TSharedPtr<FDocGenMarkdownMemberTable> MemberTable = MakeShared<FDocGenMarkdownMemberTable>();
+	// Guards the pointers above, read by CreateSerializer from the threads writing the docs
+	FCriticalSection SharedStateLock;
+};
@@ -0,0 +1,83 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "OutputFormats/DocGenMarkdownOutputProcessor.h"
+#include "HAL/FileManager.h"
+#include "KantanDocGenLog.h"
+#include "KantanDocGenTrace.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "OutputFormats/DocGenMarkdownOutputFormat.h"
+#include "OutputFormats/DocGenUtf8FileWriter.h"
+
+DocGenMarkdownOutputProcessor::DocGenMarkdownOutputProcessor(TSharedPtr<FDocGenMarkdownMemberTable> InMemberTable,
+															 TSharedPtr<const TSet<FString>> InDocumentedClassIds)
+	: MemberTable(MoveTemp(InMemberTable))
+	, DocumentedClassIds(MoveTemp(InDocumentedClassIds))
+{}
+
+EIntermediateProcessingResult DocGenMarkdownOutputProcessor::ProcessIntermediateDocs(FString const& IntermediateDir,
+																					 FString const& OutputDir,
+																					 FString const& DocTitle,
+																					 bool bCleanOutput)
+{
+	KANTANDOCGEN_TRACE_SCOPE(DocGenMarkdownOutputProcessor::ProcessIntermediateDocs);
+	IFileManager& FileManager = IFileManager::Get();
+	const FString DocOutputDir = OutputDir / DocTitle;
+
+	if (bCleanOutput && FileManager.DirectoryExists(*DocOutputDir))
+	{
+		FileManager.DeleteDirectory(*DocOutputDir, false, true);
+	}
+
+	// Pages kept by an incremental build may reference types whose page wasn't rendered by this run either
+	if (MemberTable)
+	{
+		MemberTable->LoadSavedRows(IntermediateDir);
+	}
+
+	// Same layout as the intermediate docs, images are referenced relatively to the pages
+	TArray<FString> Files;
+	FileManager.FindFilesRecursive(Files, *IntermediateDir, TEXT("*.md"), true, false);
+	FileManager.FindFilesRecursive(Files, *IntermediateDir, TEXT("*.png"), true, false, false);
+
+	int32 NumFailures = 0;
+	for (const FString& SourceFile : Files)
+	{
+		FString RelativePath = SourceFile;
+		if (!FPaths::MakePathRelativeTo(RelativePath, *(IntermediateDir / TEXT(""))))
+		{
+			continue;
+		}
+
+		if (MemberTable && FPaths::GetExtension(SourceFile) == TEXT("md"))
+		{
+			FString Page;
+			FDocGenUtf8FileWriter FileWriter;
+			if (!FFileHelper::LoadFileToString(Page, *SourceFile) || !FileWriter.Open(DocOutputDir / RelativePath))
+			{
+				UE_LOG(LogKantanDocGen, Error, TEXT("Failed to copy %s to %s"), *SourceFile, *DocOutputDir);
+				++NumFailures;
+				continue;
+			}
+			FileWriter.Write(MemberTable->ResolveReferences(Page, DocumentedClassIds.Get()));
+			if (!FileWriter.Close())
+			{
+				UE_LOG(LogKantanDocGen, Error, TEXT("Failed to copy %s to %s"), *SourceFile, *DocOutputDir);
+				++NumFailures;
+			}
+		}
+		else if (FileManager.Copy(*(DocOutputDir / RelativePath), *SourceFile) != COPY_OK)
+		{
+			UE_LOG(LogKantanDocGen, Error, TEXT("Failed to copy %s to %s"), *SourceFile, *DocOutputDir);
+			++NumFailures;
+		}
+	}
+
+	UE_LOG(LogKantanDocGen, Log, TEXT("Copied %d markdown files and images to %s"), Files.Num() - NumFailures,
+		   *DocOutputDir);
+	return NumFailures > 0 ? EIntermediateProcessingResult::DiskWriteFailure : EIntermediateProcessingResult::Success;
+}
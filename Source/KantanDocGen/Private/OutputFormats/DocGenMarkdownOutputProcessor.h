@@ -0,0 +1,27 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#pragma once
+#include "OutputFormats/DocGenOutputProcessor.h"
+
+class FDocGenMarkdownMemberTable;
+
+// The markdown pages are rendered with the intermediate docs, only the pages and node images are copied to the output.
+// Pages referencing inherited members get the rows of these members on the way, and lose the rows inherited from
+// undocumented types when these weren't known while the pages were rendered.
+class DocGenMarkdownOutputProcessor : public IDocGenOutputProcessor
+{
+	TSharedPtr<FDocGenMarkdownMemberTable> MemberTable;
+	// Ids of the classes listed in the index, null if unknown
+	TSharedPtr<const TSet<FString>> DocumentedClassIds;
+
+public:
+	DocGenMarkdownOutputProcessor(TSharedPtr<FDocGenMarkdownMemberTable> InMemberTable,
+								  TSharedPtr<const TSet<FString>> InDocumentedClassIds);
+	virtual EIntermediateProcessingResult ProcessIntermediateDocs(FString const& IntermediateDir,
+																  FString const& OutputDir, FString const& DocTitle,
+																  bool bCleanOutput) override;
+};
@@ -15,6 +15,8 @@ class KANTANDOCGEN_API UDocGenOutputFormatFactoryBase : public UObject, public I
 public:
 	virtual FString GetFormatIdentifier()
 		PURE_VIRTUAL(IDocGenOutputFormatFactory::GetFormatIdentifier, return FString(););
+	/// @brief Must be thread safe: docs are written from several threads at once, while the game thread may be calling
+	/// BeginFinalize or CreateIntermediateDocProcessor. Each returned serializer is only used by one thread.
 	virtual TSharedPtr<DocTreeNode::IDocTreeSerializer> CreateSerializer()
 		PURE_VIRTUAL(IDocGenOutputFormatFactory::CreateSerializer, return nullptr;);
 	virtual TSharedPtr<struct IDocGenOutputProcessor> CreateIntermediateDocProcessor()
@@ -23,4 +25,8 @@ public:
 			PURE_VIRTUAL(IDocGenOutputFormatFactory::LoadSettings, );
 	virtual FDocGenOutputFormatFactorySettings SaveSettings()
 		PURE_VIRTUAL(IDocGenOutputFormatFactory::SaveSettings, return {};);
+
+	/// @brief Called on the game thread once all docs are generated, before the index and type docs are saved
+	/// @param IndexDocTree complete index of the documented types
+	virtual void BeginFinalize(TSharedPtr<const DocTreeNode> IndexDocTree) {}
 };
\ No newline at end of file
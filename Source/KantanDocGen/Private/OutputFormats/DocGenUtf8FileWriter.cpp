@@ -0,0 +1,167 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "OutputFormats/DocGenUtf8FileWriter.h"
+#include "HAL/FileManager.h"
+#include "KantanDocGenLog.h"
+#include "KantanDocGenTrace.h"
+
+namespace
+{
+	const int32 BufferSize = 64 * 1024;
+
+	bool IsHighSurrogate(uint32 Char) { return Char >= 0xD800 && Char <= 0xDBFF; }
+	bool IsLowSurrogate(uint32 Char) { return Char >= 0xDC00 && Char <= 0xDFFF; }
+} // namespace
+
+FDocGenUtf8FileWriter::FDocGenUtf8FileWriter()
+{
+	SetIsSaving(true);
+}
+
+FDocGenUtf8FileWriter::~FDocGenUtf8FileWriter()
+{
+	Close();
+}
+
+bool FDocGenUtf8FileWriter::Open(const FString& InFilename)
+{
+	Close();
+
+	Filename = InFilename;
+	FileWriter.Reset(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!FileWriter)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to open %s for writing"), *Filename);
+		SetError();
+		return false;
+	}
+
+	Buffer.Reset(BufferSize);
+	return true;
+}
+
+void FDocGenUtf8FileWriter::Write(FStringView Text)
+{
+	WriteChars(Text.GetData(), Text.Len());
+}
+
+void FDocGenUtf8FileWriter::Serialize(void* Data, int64 Num)
+{
+	check(Num % sizeof(TCHAR) == 0);
+	WriteChars(static_cast<const TCHAR*>(Data), static_cast<int32>(Num / sizeof(TCHAR)));
+}
+
+void FDocGenUtf8FileWriter::WriteChars(const TCHAR* Chars, int32 NumChars)
+{
+	for (int32 Index = 0; Index < NumChars; ++Index)
+	{
+		const uint32 Char = static_cast<uint32>(Chars[Index]);
+
+		if (PendingHighSurrogate != 0)
+		{
+			const uint32 HighSurrogate = PendingHighSurrogate;
+			PendingHighSurrogate = 0;
+			if (IsLowSurrogate(Char))
+			{
+				WriteCodepoint(0x10000 + ((HighSurrogate - 0xD800) << 10) + (Char - 0xDC00));
+				continue;
+			}
+			// Unpaired, written as is like FTCHARToUTF8 does
+			WriteCodepoint(HighSurrogate);
+		}
+
+		if (Char < 0x80)
+		{
+			Buffer.Add(static_cast<uint8>(Char));
+		}
+		else if (IsHighSurrogate(Char))
+		{
+			PendingHighSurrogate = Char;
+		}
+		else
+		{
+			WriteCodepoint(Char);
+		}
+	}
+
+	if (Buffer.Num() >= BufferSize)
+	{
+		FlushBuffer();
+	}
+}
+
+void FDocGenUtf8FileWriter::WriteCodepoint(uint32 Codepoint)
+{
+	if (Codepoint < 0x80)
+	{
+		Buffer.Add(static_cast<uint8>(Codepoint));
+	}
+	else if (Codepoint < 0x800)
+	{
+		Buffer.Add(static_cast<uint8>(0xC0 | (Codepoint >> 6)));
+		Buffer.Add(static_cast<uint8>(0x80 | (Codepoint & 0x3F)));
+	}
+	else if (Codepoint < 0x10000)
+	{
+		Buffer.Add(static_cast<uint8>(0xE0 | (Codepoint >> 12)));
+		Buffer.Add(static_cast<uint8>(0x80 | ((Codepoint >> 6) & 0x3F)));
+		Buffer.Add(static_cast<uint8>(0x80 | (Codepoint & 0x3F)));
+	}
+	else if (Codepoint <= 0x10FFFF)
+	{
+		Buffer.Add(static_cast<uint8>(0xF0 | (Codepoint >> 18)));
+		Buffer.Add(static_cast<uint8>(0x80 | ((Codepoint >> 12) & 0x3F)));
+		Buffer.Add(static_cast<uint8>(0x80 | ((Codepoint >> 6) & 0x3F)));
+		Buffer.Add(static_cast<uint8>(0x80 | (Codepoint & 0x3F)));
+	}
+	else
+	{
+		Buffer.Add('?');
+	}
+}
+
+void FDocGenUtf8FileWriter::FlushBuffer()
+{
+	if (FileWriter && Buffer.Num() > 0)
+	{
+		FileWriter->Serialize(Buffer.GetData(), Buffer.Num());
+		TRACE_COUNTER_ADD(KantanDocGen_BytesWritten, Buffer.Num());
+	}
+	Buffer.Reset();
+}
+
+void FDocGenUtf8FileWriter::Flush()
+{
+	FlushBuffer();
+	if (FileWriter)
+	{
+		FileWriter->Flush();
+	}
+}
+
+bool FDocGenUtf8FileWriter::Close()
+{
+	if (!FileWriter)
+	{
+		return !IsError();
+	}
+
+	if (PendingHighSurrogate != 0)
+	{
+		WriteCodepoint(PendingHighSurrogate);
+		PendingHighSurrogate = 0;
+	}
+	FlushBuffer();
+
+	if (!FileWriter->Close() || FileWriter->IsError())
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to write %s"), *Filename);
+		SetError();
+	}
+	FileWriter.Reset();
+	return !IsError();
+}
@@ -0,0 +1,40 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+
+// Buffered file output converting the TCHAR text it receives to UTF-8 (without BOM).
+// As an archive, it can be given to writers streaming TCHARs (e.g. TJsonWriter), so documents are written
+// to disk while being serialized instead of being built in memory first.
+class FDocGenUtf8FileWriter : public FArchive
+{
+public:
+	FDocGenUtf8FileWriter();
+	virtual ~FDocGenUtf8FileWriter();
+
+	bool Open(const FString& InFilename);
+	void Write(FStringView Text);
+
+	// Data is expected to be TCHARs
+	virtual void Serialize(void* Data, int64 Num) override;
+	virtual void Flush() override;
+	virtual bool Close() override;
+	virtual FString GetArchiveName() const override { return Filename; }
+
+private:
+	void WriteChars(const TCHAR* Chars, int32 NumChars);
+	void WriteCodepoint(uint32 Codepoint);
+	void FlushBuffer();
+
+	TUniquePtr<FArchive> FileWriter;
+	FString Filename;
+	TArray<uint8> Buffer;
+	// Writers may split surrogate pairs across calls when they output one character at a time
+	uint32 PendingHighSurrogate = 0;
+};
@@ -1,12 +1,14 @@
 #include "OutputFormats/DocGenXMLOutputFormat.h"
+#include "Misc/FileHelper.h"
+#include "Misc/EngineVersionComparison.h"
+#include "OutputFormats/DocGenUtf8FileWriter.h"
 #include "OutputFormats/DocGenXMLOutputProcessor.h"
-#include "XmlFile.h"
- 
-FString DocGenXMLSerializer::EscapeString(const FString& InString) const
+
+namespace
 {
-	return TEXT("<![CDATA[") + InString + TEXT("]]>");
+	const FString RootTag = TEXT("root");
 }
-
+ 
 FString DocGenXMLSerializer::GetFileExtension() const
 {
 	return TEXT(".xml");
@@ -14,42 +16,172 @@ FString DocGenXMLSerializer::GetFileExtension() const
 
 void DocGenXMLSerializer::SerializeObject(const DocTreeNode::Object& Obj)
 {
+	BeginDocument();
+
+	// for each value in Obj
+	// open an element using the key as a name
+	// then call SerializeWith and pass ourselves
 	for (auto& Member : Obj)
 	{
-		TargetNode->AppendChildNode(Member.Key, FString());
-		Member.Value->SerializeWith(MakeShared<DocGenXMLSerializer>(TargetNode->GetChildrenNodes().Last()));
+		OpenElement(Member.Key);
+		Member.Value->SerializeWith(AsShared());
+		CloseElement();
 	}
-	// for each value in Obj
-	// create a node using the key as a name
-	// then call SerializeWith and pass ourselves
 }
 
-void DocGenXMLSerializer::SerializeString(const FString& InString)
+void DocGenXMLSerializer::SerializeString(FStringView InString, bool bEscape)
+{
+	BeginDocument();
+
+	// Empty elements are written as <Tag />, escaped values always have a CDATA section
+	if (InString.IsEmpty() && !bEscape)
+	{
+		return;
+	}
+
+	check(bStartTagOpen);
+	Write(TEXT(">"));
+	if (bEscape)
+	{
+		WriteEscaped(InString);
+	}
+	else
+	{
+		Write(InString);
+	}
+	bStartTagOpen = false;
+	bContentWritten = true;
+}
+
+void DocGenXMLSerializer::SerializeNull()
+{
+	BeginDocument();
+}
+
+void DocGenXMLSerializer::BeginDocument()
+{
+	if (bStarted)
+	{
+		return;
+	}
+
+	bStarted = true;
+	Write(TEXT("<?xml version=\"1.0\" encoding=\"UTF-8\"?>") LINE_TERMINATOR);
+	OpenElement(RootTag);
+}
+
+void DocGenXMLSerializer::OpenElement(const FString& Tag)
+{
+	// The parent has children, so it needs an end tag
+	if (bStartTagOpen)
+	{
+		Write(TEXT(">") LINE_TERMINATOR);
+		bStartTagOpen = false;
+	}
+
+	WriteIndent(ElementStack.Num());
+	Write(TEXT("<"));
+	Write(Tag);
+	ElementStack.Push(&Tag);
+	bStartTagOpen = true;
+}
+
+void DocGenXMLSerializer::CloseElement()
 {
-	TargetNode->SetContent(InString);
+	check(ElementStack.Num() > 0);
+
+	if (bStartTagOpen)
+	{
+		Write(TEXT(" />") LINE_TERMINATOR);
+		bStartTagOpen = false;
+	}
+	else
+	{
+		// An element with children has its end tag on its own line, an element with content on the same line
+		if (!bContentWritten)
+		{
+			WriteIndent(ElementStack.Num() - 1);
+		}
+		Write(TEXT("</"));
+		Write(*ElementStack.Last());
+		Write(TEXT(">") LINE_TERMINATOR);
+		bContentWritten = false;
+	}
+
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+	ElementStack.Pop(false);
+#else
+	ElementStack.Pop(EAllowShrinking::No);
+#endif
 }
 
-void DocGenXMLSerializer::SerializeNull() {}
+void DocGenXMLSerializer::WriteIndent(int32 Depth)
+{
+	for (int32 Index = 0; Index < Depth; ++Index)
+	{
+		Write(TEXT("\t"));
+	}
+}
 
-DocGenXMLSerializer::DocGenXMLSerializer()
+void DocGenXMLSerializer::Write(FStringView Text)
 {
-	const FString FileTemplate = R"xxx(<?xml version="1.0" encoding="UTF-8"?>)xxx"
-								 "\r\n"
-								 R"xxx(<root></root>)xxx";
+	if (FileWriter)
+	{
+		FileWriter->Write(Text);
+	}
+	else
+	{
+		Buffer.Append(Text.GetData(), Text.Len());
+	}
+}
 
-	TopLevelFile = MakeShared<FXmlFile>(FileTemplate, EConstructMethod::ConstructFromBuffer);
-	TargetNode = TopLevelFile->GetRootNode();
+void DocGenXMLSerializer::WriteEscaped(FStringView Text)
+{
+	Write(TEXT("<![CDATA["));
+	// A "]]>" in the string would end the section early, split it across two sections
+	int32 SectionEnd;
+	while ((SectionEnd = Text.Find(TEXT("]]>"))) != INDEX_NONE)
+	{
+		Write(Text.Left(SectionEnd + 2));
+		Write(TEXT("]]><![CDATA["));
+		Text.RightChopInline(SectionEnd + 2);
+	}
+	Write(Text);
+	Write(TEXT("]]>"));
 }
 
-DocGenXMLSerializer::DocGenXMLSerializer(FXmlNode* TargetNode) : TargetNode(TargetNode) {}
+DocGenXMLSerializer::DocGenXMLSerializer() {}
+
+DocGenXMLSerializer::~DocGenXMLSerializer() = default;
+
+void DocGenXMLSerializer::BeginFile(const FString& OutFileDirectory, const FString& OutFileName)
+{
+	check(!bStarted);
+
+	FileWriter = MakeUnique<FDocGenUtf8FileWriter>();
+	if (!FileWriter->Open(OutFileDirectory / OutFileName + GetFileExtension()))
+	{
+		// Buffer the document instead, SaveToFile will try again
+		FileWriter.Reset();
+	}
+}
 
 bool DocGenXMLSerializer::SaveToFile(const FString& OutFileDirectory, const FString& OutFileName)
 {
-	if (!TopLevelFile)
+	BeginDocument();
+	while (ElementStack.Num() > 0)
 	{
-		return false;
+		CloseElement();
 	}
-	return TopLevelFile->Save(OutFileDirectory / OutFileName + GetFileExtension());
+
+	if (FileWriter)
+	{
+		// Already written to the file given to BeginFile
+		return FileWriter->Close();
+	}
+
+	return FFileHelper::SaveStringToFile(Buffer, *(OutFileDirectory / OutFileName + GetFileExtension()),
+										 FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
 }
 
 TSharedPtr<struct DocTreeNode::IDocTreeSerializer> UDocGenXMLOutputFactory::CreateSerializer()
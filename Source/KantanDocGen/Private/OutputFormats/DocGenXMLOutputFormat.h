@@ -6,20 +6,37 @@
 
 #include "DocGenXMLOutputFormat.generated.h"
 
-class DocGenXMLSerializer : public DocTreeNode::IDocTreeSerializer
+// Writes the doc tree as XML while walking it, in the same layout FXmlFile::Save produces.
+// Keys become elements, strings their content.
+class DocGenXMLSerializer : public DocTreeNode::IDocTreeSerializer, public TSharedFromThis<DocGenXMLSerializer>
 {
-	TSharedPtr<class FXmlFile> TopLevelFile;
-	class FXmlNode* TargetNode;
-	virtual FString EscapeString(const FString& InString) const override;
+	// Set when streaming to a file (see BeginFile), otherwise the document is buffered until SaveToFile
+	TUniquePtr<class FDocGenUtf8FileWriter> FileWriter;
+	FString Buffer;
+
+	// Tags of the elements being written, the first one is the root. They are owned by the doc tree being serialized.
+	TArray<const FString*, TInlineAllocator<16>> ElementStack;
+	bool bStarted = false;
+	// The start tag of the last opened element isn't terminated yet, as it's not known yet if it will be empty
+	bool bStartTagOpen = false;
+	bool bContentWritten = false;
+
 	virtual FString GetFileExtension() const override;
 	virtual void SerializeObject(const DocTreeNode::Object& Obj) override;
-	virtual void SerializeString(const FString& InString) override;
+	virtual void SerializeString(FStringView InString, bool bEscape) override;
 	virtual void SerializeNull() override;
 
+	void BeginDocument();
+	void OpenElement(const FString& Tag);
+	void CloseElement();
+	void WriteIndent(int32 Depth);
+	void Write(FStringView Text);
+	void WriteEscaped(FStringView Text);
+
 public:
-	// constructor taking initial document state
-	DocGenXMLSerializer(FXmlNode* TargetNode);
 	DocGenXMLSerializer();
+	virtual ~DocGenXMLSerializer();
+	virtual void BeginFile(const FString& OutFileDirectory, const FString& OutFileName) override;
 	virtual bool SaveToFile(const FString& OutFileDirectory, const FString& OutFileName);;
 };
 
@@ -2,12 +2,14 @@
 #include "HAL/PlatformProcess.h"
 #include "Interfaces/IPluginManager.h"
 #include "KantanDocGenLog.h"
+#include "KantanDocGenTrace.h"
 
 EIntermediateProcessingResult DocGenXMLOutputProcessor::ProcessIntermediateDocs(FString const& IntermediateDir,
 																				FString const& OutputDir,
 																				FString const& DocTitle,
 																				bool bCleanOutput)
 {
+	KANTANDOCGEN_TRACE_SCOPE(DocGenXMLOutputProcessor::ProcessIntermediateDocs);
 	auto& PluginManager = IPluginManager::Get();
 	auto Plugin = PluginManager.FindPlugin(TEXT("KantanDocGen"));
 	if (!Plugin.IsValid())
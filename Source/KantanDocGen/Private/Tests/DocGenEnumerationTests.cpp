@@ -0,0 +1,59 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Enumeration/NativeModuleEnumerator.h"
+#include "Enumeration/SpecificClassEnumerator.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenEnumerationOverlapTest, "KantanDocGen.Enumeration.ClassByNameAndModule",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenEnumerationOverlapTest::RunTest(const FString& Parameters)
+{
+	UClass* const ActorClass = AActor::StaticClass();
+
+	// Same enumerators as a run documenting the Engine module and the Actor class by name
+	FSpecificClassEnumerator ByName({ActorClass->GetFName()});
+	FNativeModuleEnumerator ByModule(TArray<FName> {TEXT("Engine")});
+
+	TSet<TWeakObjectPtr<UObject>> Enumerated;
+	int32 NumFromName = 0;
+	while (UObject* Obj = ByName.GetNextUnique(Enumerated))
+	{
+		NumFromName += Obj == ActorClass;
+	}
+
+	int32 NumFromModule = 0;
+	int32 NumStructsFromModule = 0;
+	while (UObject* Obj = ByModule.GetNextUnique(Enumerated))
+	{
+		NumFromModule += Obj == ActorClass;
+		NumStructsFromModule += Obj->IsA<UScriptStruct>();
+	}
+
+	TestEqual(TEXT("Class enumerated by name"), NumFromName, 1);
+	TestEqual(TEXT("Class enumerated again by its module"), NumFromModule, 0);
+	// Types without actions (structs, enums) are the ones which used to be documented twice
+	TestTrue(TEXT("Module still enumerates the other types"), NumStructsFromModule > 0);
+
+	// Without the shared set, the module does yield the class
+	FNativeModuleEnumerator ModuleOnly(TArray<FName> {TEXT("Engine")});
+	TSet<TWeakObjectPtr<UObject>> ModuleEnumerated;
+	bool bModuleYieldsClass = false;
+	while (UObject* Obj = ModuleOnly.GetNextUnique(ModuleEnumerated))
+	{
+		bModuleYieldsClass |= Obj == ActorClass;
+	}
+	TestTrue(TEXT("Module enumerates the class"), bModuleYieldsClass);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,92 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "DocGenHelper.h"
+#include "DocGenManifest.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenManifestContributionsTest, "KantanDocGen.Incremental.ManifestContributions",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenManifestContributionsTest::RunTest(const FString& Parameters)
+{
+	const FString Path = FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("DocGenManifest"), TEXT(".json"));
+
+	FDocGenManifest Manifest;
+	Manifest.SetTypeFingerprint(TEXT("Classes/MyLibrary"), TEXT("A"));
+	Manifest.AddContribution(TEXT("Classes/MyLibrary"), TEXT("Classes/Actor"));
+	Manifest.AddContribution(TEXT("Classes/MyLibrary"), TEXT("Classes/Pawn"));
+	Manifest.AddContribution(TEXT("Classes/OtherLibrary"), TEXT("Classes/Actor"));
+	TestTrue(TEXT("Manifest saved"), Manifest.Save(Path));
+
+	FDocGenManifest Loaded;
+	TestTrue(TEXT("Manifest loaded"), Loaded.Load(Path));
+	IFileManager::Get().Delete(*Path);
+
+	TestEqual(TEXT("Targets of a source"), Loaded.FindContributionTargets(TEXT("Classes/MyLibrary")),
+			  TArray<FString> {TEXT("Classes/Actor"), TEXT("Classes/Pawn")});
+	TArray<FString> ActorContributors = Loaded.FindContributors(TEXT("Classes/Actor"));
+	ActorContributors.Sort();
+	TestEqual(TEXT("Contributors of a class"), ActorContributors,
+			  TArray<FString> {TEXT("Classes/MyLibrary"), TEXT("Classes/OtherLibrary")});
+
+	// A source skipped by the next run keeps its contributions
+	FDocGenManifest Next;
+	Next.CopyContributions(Loaded, TEXT("Classes/OtherLibrary"));
+	TestEqual(TEXT("Copied targets"), Next.FindContributionTargets(TEXT("Classes/OtherLibrary")),
+			  TArray<FString> {TEXT("Classes/Actor")});
+	TestEqual(TEXT("Other sources aren't copied"), Next.FindContributionTargets(TEXT("Classes/MyLibrary")).Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenDeleteFilesNotWrittenTest, "KantanDocGen.Incremental.DeleteFilesNotWritten",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenDeleteFilesNotWrittenTest::RunTest(const FString& Parameters)
+{
+	const FString Dir = FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("DocGenStale"));
+	const FString TypeDir = Dir / TEXT("Classes/MyClass");
+
+	// Files of the previous run
+	for (const TCHAR* File : {TEXT("MyClass.xml"), TEXT("MyClass.json"), TEXT("MyClass.rows.json"), TEXT("Nodes/Kept/Kept.xml"),
+							  TEXT("Nodes/Kept/img/nd_img_Kept.png"), TEXT("Nodes/Removed/Removed.xml"),
+							  TEXT("Nodes/Removed/img/nd_img_Removed.png")})
+	{
+		FFileHelper::SaveStringToFile(TEXT("-"), *(TypeDir / File));
+	}
+
+	// What this run wrote again, without the extensions of the formats
+	FDocGenHelper::BeginRecordingWrittenFiles();
+	FDocGenHelper::RecordWrittenFile(TypeDir / TEXT("MyClass"));
+	FDocGenHelper::RecordWrittenFile(TypeDir / TEXT("Nodes/Kept/Kept"));
+	FDocGenHelper::RecordWrittenFile(TypeDir / TEXT("Nodes/Kept/img/nd_img_Kept.png"));
+
+	TestEqual(TEXT("Stale files deleted"), FDocGenHelper::DeleteFilesNotWritten(TypeDir), 2);
+	TestTrue(TEXT("Doc kept"), FPaths::FileExists(TypeDir / TEXT("MyClass.xml")));
+	TestTrue(TEXT("Doc sidecar kept"), FPaths::FileExists(TypeDir / TEXT("MyClass.rows.json")));
+	TestTrue(TEXT("Image kept"), FPaths::FileExists(TypeDir / TEXT("Nodes/Kept/img/nd_img_Kept.png")));
+	TestFalse(TEXT("Removed node doc deleted"), FPaths::FileExists(TypeDir / TEXT("Nodes/Removed/Removed.xml")));
+	TestFalse(TEXT("Removed node image deleted"), FPaths::FileExists(TypeDir / TEXT("Nodes/Removed/img/nd_img_Removed.png")));
+
+	// Nothing written in a removed type
+	const FString RemovedTypeDir = Dir / TEXT("Classes/Removed");
+	FFileHelper::SaveStringToFile(TEXT("-"), *(RemovedTypeDir / TEXT("Removed.xml")));
+	TestEqual(TEXT("Removed type deleted"), FDocGenHelper::DeleteFilesNotWritten(RemovedTypeDir), 1);
+	TestFalse(TEXT("Removed type directory deleted"), FPaths::DirectoryExists(RemovedTypeDir));
+	FDocGenHelper::EndRecordingWrittenFiles();
+
+	IFileManager::Get().DeleteDirectory(*Dir, false, true);
+	return true;
+}
+
+#endif
@@ -0,0 +1,118 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "DocTreeNode.h"
+#include "HAL/FileManager.h"
+#include "Interfaces/IPluginManager.h"
+#include "Json.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "OutputFormats/DocGenJsonOutputFormat.h"
+#include "OutputFormats/DocGenXMLOutputFormat.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// Expected outputs, in the layout of the serializers the streaming ones replaced (FXmlFile and FJsonValue trees)
+	FString GetGoldenDir()
+	{
+		return IPluginManager::Get().FindPlugin(TEXT("KantanDocGen"))->GetBaseDir() / TEXT("Source/KantanDocGen/Private/Tests/Golden");
+	}
+
+	TSharedPtr<DocTreeNode> MakeParityDoc()
+	{
+		TSharedPtr<DocTreeNode> Doc = MakeShared<DocTreeNode>();
+		Doc->AppendChildWithValue(TEXT("id"), TEXT("Actor"));
+		Doc->AppendChildWithValue(TEXT("display_name"), TEXT("Actor"));
+		Doc->AppendChildWithValueEscaped(TEXT("description"), TEXT("Uses <b>tags</b> & \"quotes\""));
+		Doc->AppendChild(TEXT("empty"));
+		Doc->AppendChild(TEXT("node"))->AppendChildWithValue(TEXT("id"), TEXT("A"));
+		Doc->AppendChild(TEXT("node"))->AppendChildWithValue(TEXT("id"), TEXT("B"));
+		TSharedPtr<DocTreeNode> List = Doc->AppendChild(TEXT("list"));
+		List->AppendChildWithValue(TEXT("item"), TEXT("1"));
+		List->AppendChildWithValue(TEXT("item"), TEXT("2"));
+		List->AppendChildWithValue(TEXT("item"), TEXT("3"));
+		// Grouped with "node" in JSON, keys used to be case insensitive
+		Doc->AppendChild(TEXT("Node"))->AppendChildWithValue(TEXT("id"), TEXT("C"));
+		Doc->AppendChild(TEXT("nested"))->AppendChild(TEXT("inner"))->AppendChildWithValue(TEXT("value"), TEXT("x"));
+		return Doc;
+	}
+
+	bool SerializeToString(const TSharedPtr<DocTreeNode>& Doc, TSharedPtr<DocTreeNode::IDocTreeSerializer> Serializer,
+						   const FString& Extension, FString& OutContent)
+	{
+		const FString Dir = FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("DocGenSerializer"));
+		Doc->SerializeWith(Serializer);
+		const bool bSaved = Serializer->SaveToFile(Dir, TEXT("Doc")) &&
+							FFileHelper::LoadFileToString(OutContent, *(Dir / TEXT("Doc") + Extension));
+		IFileManager::Get().DeleteDirectory(*Dir, false, true);
+		return bSaved;
+	}
+
+	// Ignores indentation and line terminators
+	FString NormalizeXml(const FString& Xml)
+	{
+		TArray<FString> Lines;
+		Xml.ParseIntoArrayLines(Lines);
+		for (FString& Line : Lines)
+		{
+			Line.TrimStartAndEndInline();
+		}
+		Lines.RemoveAll([](const FString& Line) { return Line.IsEmpty(); });
+		return FString::Join(Lines, TEXT("\n"));
+	}
+
+	// Ignores the formatting, but not the order of the fields
+	FString NormalizeJson(const FString& Json)
+	{
+		TSharedPtr<FJsonObject> Object;
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Object) || !Object.IsValid())
+		{
+			return FString();
+		}
+
+		FString Normalized;
+		FJsonSerializer::Serialize(Object.ToSharedRef(), TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Normalized));
+		return Normalized;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenSerializerParityTest, "KantanDocGen.Serializers.GoldenFiles",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenSerializerParityTest::RunTest(const FString& Parameters)
+{
+	const TSharedPtr<DocTreeNode> Doc = MakeParityDoc();
+
+	FString ExpectedXml;
+	FString Xml;
+	TestTrue(TEXT("XML golden file loaded"), FFileHelper::LoadFileToString(ExpectedXml, *(GetGoldenDir() / TEXT("SerializerParity.xml"))));
+	TestTrue(TEXT("XML written"), SerializeToString(Doc, MakeShared<DocGenXMLSerializer>(), TEXT(".xml"), Xml));
+	TestEqual(TEXT("XML matches the golden file"), NormalizeXml(Xml), NormalizeXml(ExpectedXml));
+
+	FString ExpectedJson;
+	FString Json;
+	TestTrue(TEXT("JSON golden file loaded"), FFileHelper::LoadFileToString(ExpectedJson, *(GetGoldenDir() / TEXT("SerializerParity.json"))));
+	for (const bool bCompact : {false, true})
+	{
+		TestTrue(TEXT("JSON written"), SerializeToString(Doc, MakeShared<DocGenJsonSerializer>(bCompact), TEXT(".json"), Json));
+		const FString Normalized = NormalizeJson(Json);
+		TestFalse(TEXT("JSON is valid"), Normalized.IsEmpty());
+		TestEqual(TEXT("JSON matches the golden file"), Normalized, NormalizeJson(ExpectedJson));
+	}
+
+	// Documents without any value are still written as an object
+	FString EmptyJson;
+	TestTrue(TEXT("Empty JSON written"), SerializeToString(MakeShared<DocTreeNode>(), MakeShared<DocGenJsonSerializer>(), TEXT(".json"), EmptyJson));
+	TestEqual(TEXT("Empty JSON document"), NormalizeJson(EmptyJson), FString(TEXT("{}")));
+
+	return true;
+}
+
+#endif
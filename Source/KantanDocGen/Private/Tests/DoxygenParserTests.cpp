@@ -0,0 +1,256 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2024 Benoit Pelletier. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "DocGenHelper.h"
+#include "DocTreeNode.h"
+#include "DoxygenParserHelpers.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Class.h"
+#include "UObject/UObjectIterator.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	using FDoxygenTags = TArray<TPair<FString, FString>>;
+
+	FDoxygenTags Tokenize(const FString& Comment)
+	{
+		FDoxygenTags Tags;
+		Detail::ForEachDoxygenTag(Comment, [&Tags](FStringView Tag, FStringView Value) {
+			Tags.Emplace(FString(Tag), FString(Value));
+		});
+		return Tags;
+	}
+
+	FString ToString(const FDoxygenTags& Tags)
+	{
+		TArray<FString> Lines;
+		for (const TPair<FString, FString>& Tag : Tags)
+		{
+			Lines.Add(FString::Printf(TEXT("%s=[%s]"), *Tag.Key, *Tag.Value));
+		}
+		return FString::Join(Lines, TEXT(", "));
+	}
+
+	// Children of the doxygen node written for Comment
+	FDoxygenTags GenerateDoxygenTags(const FString& Comment,
+									 TFunctionRef<void(const FString&, TSharedPtr<DocTreeNode>)> GenerateDoxygenNode)
+	{
+		FDoxygenTags Tags;
+		TSharedPtr<DocTreeNode> Parent = MakeShared<DocTreeNode>();
+		GenerateDoxygenNode(Comment, Parent);
+		const DocTreeNode::Object* Children = Parent->TryGetObject();
+		const DocTreeNode* Doxygen = Children ? Children->Find(TEXT("doxygen")) : nullptr;
+		if (const DocTreeNode::Object* DoxygenChildren = Doxygen ? Doxygen->TryGetObject() : nullptr)
+		{
+			for (const DocTreeNode::FChild& Child : *DoxygenChildren)
+			{
+				Tags.Emplace(Child.Key, FString(Child.Value->GetValue()));
+			}
+		}
+		return Tags;
+	}
+
+	// Parser replaced by Detail::ForEachDoxygenTag, kept as the reference of the parity test and of the benchmark
+	TMap<FString, TArray<FString>> ParseDoxygenTagsBaseline(const FString& RawDoxygenString)
+	{
+		TMap<FString, TArray<FString>> ParsedTags;
+		int32 CurStrPos = 0;
+		int32 RawStringLength = RawDoxygenString.Len();
+		do
+		{
+			CurStrPos = RawDoxygenString.Find("@", ESearchCase::IgnoreCase, ESearchDir::FromStart, CurStrPos);
+			if (CurStrPos == INDEX_NONE)
+			{
+				break;
+			}
+			CurStrPos++;
+			FString CurrentTagString;
+			while (CurStrPos < RawStringLength && !FChar::IsWhitespace(RawDoxygenString[CurStrPos]))
+			{
+				CurrentTagString.AppendChar(RawDoxygenString[CurStrPos]);
+				CurStrPos++;
+			}
+
+			while (CurStrPos < RawStringLength && FChar::IsWhitespace(RawDoxygenString[CurStrPos]))
+			{
+				++CurStrPos;
+			}
+
+			FString CurrentValueString;
+			while (CurStrPos < RawStringLength && RawDoxygenString[CurStrPos] != TEXT('@'))
+			{
+				while (CurStrPos < RawStringLength && FChar::IsLinebreak(RawDoxygenString[CurStrPos]))
+				{
+					++CurStrPos;
+					while (CurStrPos < RawStringLength && FChar::IsWhitespace(RawDoxygenString[CurStrPos]))
+					{
+						++CurStrPos;
+					}
+					if (CurStrPos < RawStringLength && !FChar::IsLinebreak(RawDoxygenString[CurStrPos]))
+					{
+						CurrentValueString.AppendChar(TEXT(' '));
+					}
+					if (CurStrPos < RawStringLength && RawDoxygenString[CurStrPos] == TEXT('*'))
+					{
+						++CurStrPos;
+						while (CurStrPos < RawStringLength && FChar::IsWhitespace(RawDoxygenString[CurStrPos]))
+						{
+							++CurStrPos;
+						}
+					}
+				}
+
+				if (CurStrPos < RawStringLength && RawDoxygenString[CurStrPos] != TEXT('@'))
+				{
+					CurrentValueString.AppendChar(RawDoxygenString[CurStrPos++]);
+				}
+			}
+
+			CurrentValueString.TrimEndInline();
+			CurrentValueString.RemoveFromEnd("/");
+			CurrentValueString.RemoveFromEnd("*");
+			CurrentValueString.TrimEndInline();
+
+			ParsedTags.FindOrAdd(CurrentTagString).Add(CurrentValueString);
+		} while (CurStrPos < RawStringLength);
+
+		return ParsedTags;
+	}
+
+	void GenerateDoxygenNodeBaseline(const FString& Comment, TSharedPtr<DocTreeNode> ParentNode)
+	{
+		auto DoxygenTags = ParseDoxygenTagsBaseline(Comment);
+		if (DoxygenTags.Num())
+		{
+			auto DoxygenElement = ParentNode->AppendChild(TEXT("doxygen"));
+			for (auto CurrentTag : DoxygenTags)
+			{
+				for (auto CurrentValue : CurrentTag.Value)
+				{
+					DoxygenElement->AppendChildWithValueEscaped(CurrentTag.Key, CurrentValue);
+				}
+			}
+		}
+	}
+
+	void GenerateDoxygenNode(const FString& Comment, TSharedPtr<DocTreeNode> ParentNode)
+	{
+		FDocGenHelper::GenerateDoxygenNodeFromComment(Comment, ParentNode);
+	}
+
+	TArray<FString> CollectFunctionComments()
+	{
+		TArray<FString> Comments;
+		for (TObjectIterator<UFunction> FunctionIt; FunctionIt; ++FunctionIt)
+		{
+			const FString& Comment = FunctionIt->GetMetaData(TEXT("Comment"));
+			if (!Comment.IsEmpty())
+			{
+				Comments.Add(Comment);
+			}
+		}
+		return Comments;
+	}
+
+	// Best time of a few passes over all the comments, each comment being parsed into its own doc tree
+	double TimeDoxygenParser(const TArray<FString>& Comments,
+							 TFunctionRef<void(const FString&, TSharedPtr<DocTreeNode>)> GenerateDoxygenNode)
+	{
+		const int32 NumPasses = 5;
+		double BestTime = TNumericLimits<double>::Max();
+		for (int32 Pass = 0; Pass < NumPasses; ++Pass)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			for (const FString& Comment : Comments)
+			{
+				GenerateDoxygenNode(Comment, MakeShared<DocTreeNode>());
+			}
+			BestTime = FMath::Min(BestTime, FPlatformTime::Seconds() - StartTime);
+		}
+		return BestTime;
+	}
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDoxygenTokenizerTest, "KantanDocGen.Doxygen.Tokenizer",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDoxygenTokenizerTest::RunTest(const FString& Parameters)
+{
+	TestEqual(TEXT("No tag"), ToString(Tokenize(TEXT("Does a thing."))), FString());
+
+	TestEqual(TEXT("@ tags"), ToString(Tokenize(TEXT("Does a thing.\n@param Value The value\n@return Nothing"))),
+			  FString(TEXT("param=[Value The value], return=[Nothing]")));
+
+	TestEqual(TEXT("\\ tags"), ToString(Tokenize(TEXT("Does a thing.\n\\param Value The value\n\\return Nothing"))),
+			  FString(TEXT("param=[Value The value], return=[Nothing]")));
+
+	// Lines are joined with a space, without the '*' of the block comment and its end
+	TestEqual(TEXT("Multi-line values"),
+			  ToString(Tokenize(TEXT("/**\n * Does a thing.\n * @param Value The value,\n *        on two lines.\n"
+									 " * @return Nothing\n */"))),
+			  FString(TEXT("param=[Value The value, on two lines.], return=[Nothing]")));
+
+	TestEqual(TEXT("Multi-line value with an empty line"), ToString(Tokenize(TEXT("@note First\n\n  Second"))),
+			  FString(TEXT("note=[First Second]")));
+
+	// Any '@' starts a tag, a '\' only at the start of a word
+	TestEqual(TEXT("@ not preceded by whitespace"), ToString(Tokenize(TEXT("Does a thing.@see Other\n@note Foo@todo Bar"))),
+			  FString(TEXT("see=[Other], note=[Foo], todo=[Bar]")));
+
+	TestEqual(TEXT("\\ not preceded by whitespace"), ToString(Tokenize(TEXT("@note Saved to C:\\Temp\\file, see\\param"))),
+			  FString(TEXT("note=[Saved to C:\\Temp\\file, see\\param]")));
+
+	TestEqual(TEXT("Empty tag"), ToString(Tokenize(TEXT("@param A\nfoo @ bar"))), FString(TEXT("param=[A foo]")));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDoxygenNodeParityTest, "KantanDocGen.Doxygen.BaselineParity",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDoxygenNodeParityTest::RunTest(const FString& Parameters)
+{
+	// Values are grouped by tag, case insensitively, in the order of the first occurrence of each tag
+	TestEqual(TEXT("Grouped by tag"),
+			  ToString(GenerateDoxygenTags(TEXT("@param A\n@return R\n@Param B\n@see S\n@param C"), GenerateDoxygenNode)),
+			  FString(TEXT("param=[A], param=[B], param=[C], return=[R], see=[S]")));
+
+	// Comments without '\' tags or empty tags ("foo @ bar") are written as before
+	for (const TCHAR* Comment : {TEXT(""), TEXT("Does a thing."), TEXT("@param A\n@return R\n@Param B\n@see S\n@param C"),
+								 TEXT("/**\n * Does a thing.\n * @param Value The value,\n *        on two lines.\n * @return Nothing\n */"),
+								 TEXT("Does a thing.@see Other\n@note Foo@todo Bar"), TEXT("@note <b>Escaped</b> & kept\n")})
+	{
+		TestEqual(FString::Printf(TEXT("Same as the baseline: %s"), Comment),
+				  ToString(GenerateDoxygenTags(Comment, GenerateDoxygenNode)),
+				  ToString(GenerateDoxygenTags(Comment, GenerateDoxygenNodeBaseline)));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDoxygenParserBenchmark, "KantanDocGen.Benchmarks.DoxygenParser",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FDoxygenParserBenchmark::RunTest(const FString& Parameters)
+{
+	const TArray<FString> Comments = CollectFunctionComments();
+	int64 NumChars = 0;
+	for (const FString& Comment : Comments)
+	{
+		NumChars += Comment.Len();
+	}
+
+	const double BaselineTime = TimeDoxygenParser(Comments, GenerateDoxygenNodeBaseline);
+	const double Time = TimeDoxygenParser(Comments, GenerateDoxygenNode);
+	AddInfo(FString::Printf(TEXT("Doxygen parser: %d comments (%lld characters) in %.2fms, baseline %.2fms"), Comments.Num(),
+							NumChars, Time * 1000.0, BaselineTime * 1000.0));
+	return true;
+}
+
+#endif
@@ -6,7 +6,13 @@
 
 #pragma once
 
+#include "Async/Async.h"
 #include "Async/TaskGraphInterfaces.h"
+#include "Containers/Array.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/EngineVersionComparison.h"
+
+#include <atomic>
 
 
 namespace DocGenThreads
@@ -36,5 +42,144 @@ namespace DocGenThreads
 		return Result;
 	}
 
-}
+	// Counts the blocking round-trips made from a worker thread to the game thread, and the time spent waiting on them.
+	struct FGameThreadHandoffStats
+	{
+		int32 NumHandoffs = 0;
+		double WaitTime = 0.0;
+	};
+
+	struct FScopedGameThreadHandoff
+	{
+		FScopedGameThreadHandoff(FGameThreadHandoffStats& InStats)
+			: Stats(InStats)
+			, StartTime(FPlatformTime::Seconds())
+		{}
 
+		~FScopedGameThreadHandoff()
+		{
+			Stats.WaitTime += FPlatformTime::Seconds() - StartTime;
+			++Stats.NumHandoffs;
+		}
+
+	private:
+		FGameThreadHandoffStats& Stats;
+		double StartTime;
+	};
+
+	// Runs Func on the game thread, blocks until it has completed and records the handoff in Stats.
+	template < typename TLambda >
+	inline auto RunOnGameThreadTracked(FGameThreadHandoffStats& Stats, TLambda Func) -> decltype(Func())
+	{
+		FScopedGameThreadHandoff Handoff(Stats);
+		return Async(EAsyncExecution::TaskGraphMainThread, MoveTemp(Func)).Get();
+	}
+
+	// Accumulates the cycles spent in a scope into a counter that may be shared between threads.
+	struct FScopedCycleAccumulator
+	{
+		FScopedCycleAccumulator(std::atomic<uint64>& InCycles)
+			: Cycles(InCycles)
+			, StartCycles(FPlatformTime::Cycles64())
+		{}
+
+		~FScopedCycleAccumulator()
+		{
+			Cycles.fetch_add(FPlatformTime::Cycles64() - StartCycles, std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<uint64>& Cycles;
+		uint64 StartCycles;
+	};
+
+	inline double CyclesToSeconds(const std::atomic<uint64>& Cycles)
+	{
+		return FPlatformTime::ToSeconds64(Cycles.load(std::memory_order_relaxed));
+	}
+
+	// FIFO of in-flight worker tasks for one pipeline stage. Adding a task blocks on the oldest ones while the stage
+	// is full, which throttles the producer instead of letting work (and memory) pile up. Not thread safe, only the
+	// producer thread should use it.
+	class FBoundedTaskQueue
+	{
+	public:
+		explicit FBoundedTaskQueue(int32 InMaxPending)
+			: MaxPending(FMath::Max(1, InMaxPending))
+		{}
+
+		~FBoundedTaskQueue()
+		{
+			WaitAll();
+		}
+
+		void Add(TFuture<bool>&& Task)
+		{
+			while (Pending.Num() - Head >= MaxPending)
+			{
+				WaitOldest();
+			}
+			Pending.Add(MoveTemp(Task));
+			++NumAdded;
+		}
+
+		// Consumes the oldest tasks which are already done, without blocking.
+		void PopCompleted()
+		{
+			while (Pending.Num() - Head > 0 && Pending[Head].IsReady())
+			{
+				WaitOldest();
+			}
+		}
+
+		void WaitAll()
+		{
+			while (Pending.Num() - Head > 0)
+			{
+				WaitOldest();
+			}
+			Pending.Reset();
+			Head = 0;
+		}
+
+		// Tasks are consumed in the order they were added, so the first GetNumCompleted() tasks ever added are done.
+		int32 GetNumAdded() const { return NumAdded; }
+		int32 GetNumCompleted() const { return NumSucceeded + NumFailed; }
+		int32 GetNumSucceeded() const { return NumSucceeded; }
+		int32 GetNumFailed() const { return NumFailed; }
+		// Time the producer spent blocked on this stage.
+		double GetWaitTime() const { return WaitTime; }
+
+	private:
+		void WaitOldest()
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			const bool bSuccess = Pending[Head].Get();
+			WaitTime += FPlatformTime::Seconds() - StartTime;
+			Pending[Head] = TFuture<bool>();
+			++Head;
+
+			bSuccess ? ++NumSucceeded : ++NumFailed;
+
+			// Compact once the consumed prefix dominates, so the array doesn't grow for the whole run
+			if (Head > MaxPending && Head * 2 > Pending.Num())
+			{
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+				Pending.RemoveAt(0, Head, false);
+#else
+				Pending.RemoveAt(0, Head, EAllowShrinking::No);
+#endif
+				Head = 0;
+			}
+		}
+
+		TArray<TFuture<bool>> Pending;
+		int32 Head = 0;
+		int32 MaxPending;
+		int32 NumAdded = 0;
+		int32 NumSucceeded = 0;
+		int32 NumFailed = 0;
+		double WaitTime = 0.0;
+	};
+
+}
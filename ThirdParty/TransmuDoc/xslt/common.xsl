@@ -37,18 +37,19 @@
 		<xsl:text>| ---- | ---- | -------- | --------- | ----------- |&#xA;</xsl:text>
 		<xsl:apply-templates select="property | field[not(inheritedFrom) or key('class-by-id', inheritedFrom/id, document('../../index.xml',.))]">
 			<xsl:sort select="inheritedFrom/id"/>
-			<xsl:sort select="category"/>
-			<xsl:sort select="display_name"/>
+			<xsl:sort select="my:resolve-member(.)/category"/>
+			<xsl:sort select="my:resolve-member(.)/display_name"/>
 		</xsl:apply-templates>
 	</xsl:template>
 	
 	<!-- Template for the property row -->
 	<xsl:template match="property|field">
+		<xsl:variable name="member" select="my:resolve-member(.)"/>
 		<xsl:text>| </xsl:text>
 		<xsl:choose>
 			<xsl:when test="../../variables and key('variable-by-id', name, ../../variables)">
 				<xsl:call-template name="link">
-					<xsl:with-param name="name" select="display_name"/>
+					<xsl:with-param name="name" select="$member/display_name"/>
 					<xsl:with-param name="href">
 						<xsl:text>./Variables/</xsl:text>
 						<xsl:value-of select="name"/>
@@ -59,7 +60,7 @@
 				</xsl:call-template>
 			</xsl:when>
 			<xsl:otherwise>
-				<xsl:apply-templates select="display_name"/>
+				<xsl:apply-templates select="($member/display_name, name)[1]"/>
 			</xsl:otherwise>
 		</xsl:choose>
 		<xsl:if test="inheritedFrom">
@@ -68,17 +69,17 @@
 			<xsl:text>)</xsl:text>
 		</xsl:if>
 		<xsl:text> | </xsl:text>
-		<xsl:value-of select="my:format(type)"/>
+		<xsl:value-of select="my:format($member/type)"/>
 		<xsl:text> | </xsl:text>
-		<xsl:value-of select="my:no_wrap(my:multiline(category))"/>
+		<xsl:value-of select="my:no_wrap(my:multiline($member/category))"/>
 		<xsl:text> | </xsl:text>
-		<xsl:apply-templates select="blueprint_access"/>
-		<xsl:if test="blueprint_access and editor_access">
+		<xsl:apply-templates select="$member/blueprint_access"/>
+		<xsl:if test="$member/blueprint_access and $member/editor_access">
 			<xsl:text>&lt;br/&gt;</xsl:text>
 		</xsl:if>
-		<xsl:apply-templates select="editor_access"/>
+		<xsl:apply-templates select="$member/editor_access"/>
 		<xsl:text> | </xsl:text>
-		<xsl:apply-templates select="description"/>
+		<xsl:apply-templates select="$member/description"/>
 		<xsl:text> |&#xA;</xsl:text>
 	</xsl:template>
 
@@ -92,24 +93,25 @@
 		<xsl:text>| ---- | -------- | ----------- |&#xA;</xsl:text>
 		<xsl:apply-templates select="event[not(inheritedFrom) or key('class-by-id', inheritedFrom/id, document('../../index.xml',.))]">
 			<xsl:sort select="inheritedFrom/id"/>
-			<xsl:sort select="category"/>
-			<xsl:sort select="display_name"/>
+			<xsl:sort select="my:resolve-member(.)/category"/>
+			<xsl:sort select="my:resolve-member(.)/display_name"/>
 		</xsl:apply-templates>
 	</xsl:template>
 
 	<!-- Template for the event row -->
 	<xsl:template match="event">
+		<xsl:variable name="member" select="my:resolve-member(.)"/>
 		<xsl:text>| </xsl:text>
-		<xsl:apply-templates select="display_name"/>
+		<xsl:apply-templates select="($member/display_name, name)[1]"/>
 		<xsl:if test="inheritedFrom">
 			<xsl:text>&lt;br/&gt;(inherited from </xsl:text>
 			<xsl:apply-templates select="inheritedFrom/display_name"/>
 			<xsl:text>)</xsl:text>
 		</xsl:if>
 		<xsl:text> | </xsl:text>
-		<xsl:value-of select="my:no_wrap(my:multiline(category))"/>
+		<xsl:value-of select="my:no_wrap(my:multiline($member/category))"/>
 		<xsl:text> | </xsl:text>
-		<xsl:apply-templates select="description"/>
+		<xsl:apply-templates select="$member/description"/>
 		<xsl:text> |&#xA;</xsl:text>
 	</xsl:template>
 	
@@ -226,6 +228,22 @@
 		<xsl:value-of select="my:no_wrap(my:format(.))"/>
 	</xsl:template>
 	
+	<!-- Members inherited with the deduplicated mode only hold their name, their entry is in the doc of the type declaring them -->
+	<xsl:function name="my:resolve-member" as="element()">
+		<xsl:param name="member" as="element()"/>
+		<xsl:choose>
+			<xsl:when test="$member/display_name or not($member/inheritedFrom)">
+				<xsl:sequence select="$member"/>
+			</xsl:when>
+			<xsl:otherwise>
+				<xsl:variable name="id" select="$member/inheritedFrom/id"/>
+				<xsl:variable name="uri" select="resolve-uri(concat('../', $id, '/', $id, '.xml'), base-uri($member))"/>
+				<xsl:variable name="owner-member" select="if (doc-available($uri)) then doc($uri)/root/*/*[node-name(.) = node-name($member)][name = $member/name] else ()"/>
+				<xsl:sequence select="($owner-member, $member)[1]"/>
+			</xsl:otherwise>
+		</xsl:choose>
+	</xsl:function>
+	
 	<xsl:function name="my:no_wrap" as="xs:string">
 		<xsl:param name="input" as="xs:string?"/>
 		<xsl:value-of select="replace($input, ' ', '&amp;nbsp;')"/>